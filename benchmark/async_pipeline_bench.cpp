@@ -0,0 +1,115 @@
+// Load test for the async submit/complete pipeline on the CPU reference backend.
+// Needs no accelerator: every knob of the emulated device is a command-line option.
+//
+//   ./async_pipeline_bench -frames=2000 -max-in-flight=8 -engines=2 -compute-us=4000 -queue=32
+//   ./async_pipeline_bench -engines=2 -engine-cpus=0-3 -submit-cpus=4 -consumer-cpus=5   (thread placement)
+//
+// Without the -*-cpus options the placement comes from the environment (placement_from_environment:
+// AI_BMT_INFERENCE_CPUS for the engines, AI_BMT_PREPROCESS_CPUS for the submitter,
+// AI_BMT_CONSUMER_CPUS or AI_BMT_NUMA_NODE). With a consumer set the output buffers are
+// first-touched on the consumer's node.
+#include "async_pipeline.hpp"
+#include "bounded_queue.hpp"
+#include "cpu_backend.hpp"
+#include "thread_placement.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t frames = std::stoul(get_option(argc, argv, "-frames", "1000"));
+    const size_t max_in_flight = std::stoul(get_option(argc, argv, "-max-in-flight", "4"));
+    const size_t consumer_delay_us = std::stoul(get_option(argc, argv, "-consumer-us", "0"));
+
+    CpuBackendConfig config;
+    config.worker_threads = std::stoul(get_option(argc, argv, "-engines", "1"));
+    config.queue_depth = std::stoul(get_option(argc, argv, "-queue", "8"));
+    config.compute_time = std::chrono::microseconds(std::stoul(get_option(argc, argv, "-compute-us", "5000")));
+    config.busy_compute = get_option(argc, argv, "-busy", "0") == "1";
+    config.inputs = {{"input", std::stoul(get_option(argc, argv, "-input-bytes", std::to_string(640 * 640 * 3)))}};
+    config.outputs = {{"output", std::stoul(get_option(argc, argv, "-output-bytes", std::to_string(80 * 501 * 4)))}};
+    const ThreadPlacementPolicy placement = placement_from_environment();
+    config.worker_cpus = CpuSet::parse(get_option(argc, argv, "-engine-cpus", placement.inference.to_string()));
+    const CpuSet submit_cpus = CpuSet::parse(get_option(argc, argv, "-submit-cpus", placement.preprocess.to_string()));
+    const CpuSet consumer_cpus = CpuSet::parse(get_option(argc, argv, "-consumer-cpus", placement.consumer.to_string()));
+    pin_current_thread(submit_cpus);
+
+    auto results = std::make_shared<BoundedTSQueue<AsyncOutputItem>>(max_in_flight * 2);
+    auto backend = std::make_shared<CpuInferBackend>(config);
+    AsyncInferPipeline pipeline(backend, [results](AsyncOutputItem &&item) { results->push(std::move(item)); }, max_in_flight,
+                                consumer_cpus);
+
+    std::vector<double> latencies_ms;
+    latencies_ms.reserve(frames);
+    size_t failed_items = 0;
+    int consumer_cpu = -1;
+    std::thread consumer([&] {
+        pin_current_thread(consumer_cpus);
+        consumer_cpu = current_cpu();
+        AsyncOutputItem item;
+        for (size_t received = 0; received < frames && results->pop(item); ++received) {
+            std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - item.submit_time;
+            latencies_ms.push_back(latency.count());
+            if (!item.success) failed_items++;
+            if (consumer_delay_us) std::this_thread::sleep_for(std::chrono::microseconds(consumer_delay_us));
+        }
+    });
+
+    auto input = std::make_shared<std::vector<uint8_t>>(config.inputs.front().frame_size, 1);
+    auto start = std::chrono::steady_clock::now();
+    size_t dropped = 0;
+    for (size_t frame_idx = 0; frame_idx < frames; ++frame_idx) {
+        if (BackendStatus::Success != pipeline.infer(input, frame_idx)) {
+            dropped++;
+        }
+    }
+    // A frame counts as completed only after its sink ran, so wait even when the consumer has seen
+    // every result; otherwise get_stats() can miss the last completions.
+    if (!pipeline.wait_for_in_flight(std::chrono::seconds(10))) {
+        std::cerr << "Timed out waiting for in-flight frames" << std::endl;
+    }
+    // Dropped frames never reach the consumer: release it.
+    if (dropped) results->stop();
+    consumer.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    AsyncInferStats stats = pipeline.get_stats();
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- CPU backend pipeline load test" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Frames:         " << frames << " (dropped " << dropped << ", failed " << failed_items << ")" << std::endl;
+    std::cout << "-I- Throughput:     " << latencies_ms.size() / elapsed.count() << " FPS" << std::endl;
+    std::cout << "-I- Latency p50:    " << percentile(latencies_ms, 50) << " ms" << std::endl;
+    std::cout << "-I- Latency p99:    " << percentile(latencies_ms, 99) << " ms" << std::endl;
+    std::cout << "-I- Submitted:      " << stats.submitted << ", completed " << stats.completed
+              << ", failed " << stats.failed << ", timeouts " << stats.timeouts << std::endl;
+    std::cout << "-I- Peak in flight: " << stats.peak_in_flight << " / " << max_in_flight << std::endl;
+    std::cout << "-I- Consumer CPUs:  " << (consumer_cpus.empty() ? std::string("unpinned") : consumer_cpus.to_string())
+              << " (started on CPU " << consumer_cpu << ")" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    return (dropped || failed_items) ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+// Compares two run reports written by Run_Recording_Submitter_Implementation (utils/run_report.hpp)
+// and exits with status 1 when the candidate regressed beyond run-to-run noise, so it can gate CI.
+//
+//   ./compare_runs run_baseline.json run_candidate.json
+//   ./compare_runs run_baseline.json run_candidate.json -resamples=5000 -confidence=0.99 -tolerance=0.05 -format=json
+#include "run_report.hpp"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+static void print_differences(const char *what, const std::vector<std::pair<std::string, std::string>> &baseline,
+                              const std::vector<std::pair<std::string, std::string>> &candidate)
+{
+    auto value_of = [](const std::vector<std::pair<std::string, std::string>> &pairs, const std::string &key) {
+        for (const auto &pair : pairs) {
+            if (pair.first == key) return pair.second;
+        }
+        return std::string("<unset>");
+    };
+    std::vector<std::string> keys;
+    for (const auto &pair : baseline) keys.push_back(pair.first);
+    for (const auto &pair : candidate) {
+        if ("<unset>" == value_of(baseline, pair.first)) keys.push_back(pair.first);
+    }
+    for (const auto &key : keys) {
+        const std::string a = value_of(baseline, key), b = value_of(candidate, key);
+        if (a != b) std::cout << "-I- " << what << " differs: " << key << ": " << a << " -> " << b << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if ('-' != argv[i][0]) paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " <baseline.json> <candidate.json> [-resamples=N] [-confidence=C] [-tolerance=T] [-format=json]" << std::endl;
+        return 2;
+    }
+
+    RunComparisonConfig config;
+    config.resamples = std::stoul(get_option(argc, argv, "-resamples", std::to_string(config.resamples)));
+    config.confidence = std::stod(get_option(argc, argv, "-confidence", std::to_string(config.confidence)));
+    config.tolerance = std::stod(get_option(argc, argv, "-tolerance", std::to_string(config.tolerance)));
+
+    RunReport baseline, candidate;
+    try {
+        baseline = read_run_report(paths[0]);
+        candidate = read_run_report(paths[1]);
+    }
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    const std::vector<MetricComparison> comparisons = compare_run_reports(baseline, candidate, config);
+    bool regression = false;
+    for (const auto &c : comparisons) regression = regression || c.regression;
+
+    if (get_option(argc, argv, "-format", "text") == "json") {
+        std::cout << "{\"regression\": " << (regression ? "true" : "false") << ", \"metrics\": [";
+        for (size_t i = 0; i < comparisons.size(); ++i) {
+            const MetricComparison &c = comparisons[i];
+            std::cout << (i ? ", " : "") << "{\"name\": \"" << c.name << "\", \"baseline\": " << c.baseline
+                      << ", \"candidate\": " << c.candidate << ", \"relative_change\": " << c.relative_change
+                      << ", \"ci_low\": " << c.ci_low << ", \"ci_high\": " << c.ci_high
+                      << ", \"significant\": " << (c.significant ? "true" : "false")
+                      << ", \"gating\": " << (c.gating ? "true" : "false")
+                      << ", \"regression\": " << (c.regression ? "true" : "false") << "}";
+        }
+        std::cout << "]}" << std::endl;
+    } else {
+        if (baseline.interface_type != candidate.interface_type) {
+            std::cout << "-I- Warning: comparing " << baseline.interface_type << " with " << candidate.interface_type << std::endl;
+        }
+        print_differences("Optional data", baseline.optional_data, candidate.optional_data);
+        print_differences("Config", baseline.config, candidate.config);
+        print_run_comparison(comparisons);
+        std::cout << "-I- " << (regression ? "Regression beyond noise detected" : "No regression beyond noise") << std::endl;
+    }
+    return regression ? 1 : 0;
+}
@@ -0,0 +1,473 @@
+// Microbenchmarks for the per-query hot paths of a submitter: VariantType construction and dispatch,
+// result construction/copy at real tensor sizes, the example preprocessing kernels, BoundedTSQueue
+// under contention and the NMS decoder behind parse_nms_data.
+//
+//   ./interface_hotpath_bench                          human-readable table
+//   ./interface_hotpath_bench -format=json > run.json  machine-readable results
+//   ./interface_hotpath_bench -filter=queue -min-time-ms=500
+#include "ai_bmt_interface.h"
+#include "bounded_queue.hpp"
+#include "nms_decoder.hpp"
+#include "../example/common/preprocess_pipeline.hpp"
+#include "../example/common/letterbox.hpp"
+#include "../example/common/compact_llm_input.hpp"
+#include "../example/common/sequence_packing.hpp"
+#include "../example/common/segmentation_upsample.hpp"
+#include "../example/common/yolo_decoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+struct CaseResult {
+    std::string name;
+    size_t iterations = 0;         // per repetition
+    double ns_per_op_median = 0;
+    double ns_per_op_min = 0;
+    double bytes_per_op = 0;       // 0 when throughput is not meaningful
+};
+
+struct Options {
+    std::string filter;
+    double min_time_ms = 200;
+    size_t repetitions = 5;
+};
+
+// `body(n)` runs the operation n times. Iterations are calibrated so that one repetition takes at
+// least `min_time_ms`; the median over repetitions is reported.
+CaseResult run_case(const Options &options, const std::string &name, double bytes_per_op,
+                    const std::function<void(size_t)> &body)
+{
+    CaseResult result;
+    result.name = name;
+    result.bytes_per_op = bytes_per_op;
+
+    size_t iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        body(iterations);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms >= options.min_time_ms || iterations >= (size_t(1) << 30)) break;
+        const double scale = ms > 0 ? options.min_time_ms / ms * 1.2 : 10;
+        iterations = std::max(iterations + 1, static_cast<size_t>(iterations * std::min(scale, 10.0)));
+    }
+
+    std::vector<double> samples;
+    for (size_t r = 0; r < options.repetitions; ++r) {
+        auto start = Clock::now();
+        body(iterations);
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    result.iterations = iterations;
+    result.ns_per_op_median = samples[samples.size() / 2];
+    result.ns_per_op_min = samples.front();
+    return result;
+}
+
+// Items/op through a BoundedTSQueue with `producers` and `consumers` threads.
+std::function<void(size_t)> queue_case(size_t producers, size_t consumers, size_t capacity)
+{
+    return [=](size_t n) {
+        BoundedTSQueue<size_t> queue(capacity);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                for (size_t i = p; i < n; i += producers) queue.push(i);
+            });
+        }
+        std::vector<size_t> sums(consumers, 0);
+        const size_t per_consumer = n / consumers;
+        // Consumer 0 also takes the remainder so exactly n items are popped.
+        for (size_t c = 0; c < consumers; ++c) {
+            const size_t count = per_consumer + (c == 0 ? n % consumers : 0);
+            threads.emplace_back([&, c, count] {
+                size_t item;
+                for (size_t i = 0; i < count && queue.pop(item); ++i) sums[c] += item;
+            });
+        }
+        for (auto &t : threads) t.join();
+        do_not_optimize(sums);
+    };
+}
+
+// Items/op through a BoundedTSQueue moved in batches: producers push_n `batch` items at a time and
+// one consumer drains with pop_n(batch, 1 ms), the dynamic-batching pattern.
+std::function<void(size_t)> batch_queue_case(size_t producers, size_t batch, size_t capacity)
+{
+    return [=](size_t n) {
+        BoundedTSQueue<size_t> queue(capacity);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                std::vector<size_t> items;
+                for (size_t i = p; i < n; i += producers) {
+                    items.push_back(i);
+                    if (items.size() == batch) {
+                        queue.push_n(std::move(items));
+                        items.clear();
+                    }
+                }
+                if (!items.empty()) queue.push_n(std::move(items));
+            });
+        }
+        size_t sum = 0;
+        std::vector<size_t> items;
+        for (size_t popped = 0; popped < n;) {
+            items.clear();
+            popped += queue.pop_n(items, batch, std::chrono::milliseconds(1));
+            for (size_t item : items) sum += item;
+        }
+        for (auto &t : threads) t.join();
+        do_not_optimize(sum);
+    };
+}
+
+// NMS-by-class buffer with `per_class` boxes in each of `classes` classes.
+std::vector<uint8_t> make_nms_buffer(size_t classes, size_t per_class)
+{
+    std::vector<uint8_t> buffer;
+    for (size_t c = 0; c < classes; ++c) {
+        float count = static_cast<float>(per_class);
+        const uint8_t *count_bytes = reinterpret_cast<const uint8_t *>(&count);
+        buffer.insert(buffer.end(), count_bytes, count_bytes + sizeof(float));
+        for (size_t b = 0; b < per_class; ++b) {
+            NmsBox box{0.1f, 0.2f, 0.5f, 0.6f, 0.9f};
+            const uint8_t *box_bytes = reinterpret_cast<const uint8_t *>(&box);
+            buffer.insert(buffer.end(), box_bytes, box_bytes + sizeof(NmsBox));
+        }
+    }
+    return buffer;
+}
+
+std::string json_escape(const std::string &s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    options.filter = get_option(argc, argv, "-filter", "");
+    options.min_time_ms = std::stod(get_option(argc, argv, "-min-time-ms", "200"));
+    options.repetitions = std::max<size_t>(1, std::stoul(get_option(argc, argv, "-repetitions", "5")));
+    const bool json = get_option(argc, argv, "-format", "text") == "json";
+
+    std::vector<CaseResult> results;
+    auto add = [&](const std::string &name, double bytes_per_op, const std::function<void(size_t)> &body) {
+        if (!options.filter.empty() && std::string::npos == name.find(options.filter)) return;
+        results.push_back(run_case(options, name, bytes_per_op, body));
+        if (!json) {
+            const CaseResult &r = results.back();
+            std::cout << r.name << ": " << r.ns_per_op_median << " ns/op (min " << r.ns_per_op_min << ")";
+            if (r.bytes_per_op > 0) std::cout << ", " << r.bytes_per_op / r.ns_per_op_median << " GB/s";
+            std::cout << std::endl;
+        }
+    };
+
+    constexpr size_t CLS_INPUT = 3 * 224 * 224;
+    constexpr size_t SEG_OUTPUT = 21 * 520 * 520;
+    constexpr size_t DET_OUTPUT = 25200 * 85;
+
+    // --- VariantType ---
+    const std::vector<float> cls_input(CLS_INPUT, 0.5f);
+    const VariantType cls_variant = cls_input;
+    add("variant/construct_move_vector_float_150k", CLS_INPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<float> v(cls_input);
+            VariantType variant = std::move(v);
+            do_not_optimize(variant);
+        }
+    });
+    add("variant/copy_vector_float_150k", CLS_INPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            VariantType copy = cls_variant;
+            do_not_optimize(copy);
+        }
+    });
+    add("variant/get_ref", 0, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const auto &v = std::get<std::vector<float>>(cls_variant);
+            do_not_optimize(v.data());
+        }
+    });
+    add("variant/get_if", 0, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const auto *v = std::get_if<std::vector<float>>(&cls_variant);
+            do_not_optimize(v);
+        }
+    });
+    add("variant/get_copy_out_150k", CLS_INPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<float> v = std::get<std::vector<float>>(cls_variant);
+            do_not_optimize(v.data());
+        }
+    });
+
+    // --- Results at real tensor sizes ---
+    const std::vector<float> cls_output(1000, 0.001f);
+    const std::vector<float> det_output(DET_OUTPUT, 0.1f);
+    const std::vector<float> seg_output(SEG_OUTPUT, 0.1f);
+    add("result/vision_classification_assign", 1000 * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            BMTVisionResult result;
+            result.classProbabilities = cls_output;
+            do_not_optimize(result);
+        }
+    });
+    add("result/vision_detection_assign", DET_OUTPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            BMTVisionResult result;
+            result.objectDetectionResult = det_output;
+            do_not_optimize(result);
+        }
+    });
+    add("result/vision_segmentation_assign", SEG_OUTPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            BMTVisionResult result;
+            result.segmentationResult = seg_output;
+            do_not_optimize(result);
+        }
+    });
+    add("result/vision_segmentation_move", 0, [&](size_t n) {
+        std::vector<float> buffer(SEG_OUTPUT);
+        for (size_t i = 0; i < n; ++i) {
+            BMTVisionResult result;
+            result.segmentationResult = std::move(buffer);
+            buffer = std::move(result.segmentationResult);
+            do_not_optimize(buffer);
+        }
+    });
+    add("result/vision_segmentation_batch_copy_x8", 8 * SEG_OUTPUT * sizeof(float), [&](size_t n) {
+        std::vector<BMTVisionResult> batch(8);
+        for (auto &r : batch) r.segmentationResult = seg_output;
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<BMTVisionResult> copy = batch;
+            do_not_optimize(copy);
+        }
+    });
+    const std::vector<float> llm_logits(8 * 50257, 0.1f); // GPT-2 logits, 8 tokens
+    add("result/llm_logits_assign", llm_logits.size() * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            BMTLLMResult result;
+            result.rawOutput = llm_logits;
+            result.rawOutputShape = {1, 8, 50257};
+            do_not_optimize(result);
+        }
+    });
+
+    // --- Preprocessing kernels ---
+    std::vector<uint8_t> image224(224 * 224 * 3), image520(520 * 520 * 3), image720p(1280 * 720 * 3);
+    for (size_t i = 0; i < image720p.size(); ++i) {
+        if (i < image224.size()) image224[i] = static_cast<uint8_t>(i * 7);
+        if (i < image520.size()) image520[i] = static_cast<uint8_t>(i * 5);
+        image720p[i] = static_cast<uint8_t>(i * 3);
+    }
+    std::vector<float> tensor(3 * 640 * 640);
+    add("preprocess/classification_224", image224.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            ClassificationPreprocessor::run(image224.data(), 224 * 3, tensor.data());
+            do_not_optimize(tensor.data());
+        }
+    });
+    add("preprocess/segmentation_520", image520.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            SegmentationPreprocessor::run(image520.data(), 520 * 3, tensor.data());
+            do_not_optimize(tensor.data());
+        }
+    });
+    add("preprocess/letterbox_720p_to_640", image720p.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            letterboxToCHW<float>(image720p.data(), 1280, 720, 1280 * 3, 640, 640, true, 1.0f / 255, 114.0f / 255, tensor.data());
+            do_not_optimize(tensor.data());
+        }
+    });
+
+    LLMPreprocessedInput llm_input;
+    llm_input.N = 1;
+    llm_input.S = 512;
+    llm_input.input_ids.assign(512, 0);
+    llm_input.attention_mask.assign(512, 0);
+    llm_input.token_type_ids.assign(512, 0);
+    for (size_t t = 0; t < 300; ++t) {
+        llm_input.input_ids[t] = 1000 + t;
+        llm_input.attention_mask[t] = 1;
+        llm_input.token_type_ids[t] = t >= 150;
+    }
+    std::vector<int32_t> compact;
+    LLMTensorScratch scratch;
+    add("preprocess/llm_pack_compact_512", 3 * 512 * sizeof(int64_t), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            packLLMInput(llm_input, true, true, compact);
+            do_not_optimize(compact.data());
+        }
+    });
+    packLLMInput(llm_input, true, true, compact);
+    add("preprocess/llm_expand_compact_512", 3 * 512 * sizeof(int64_t), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            expandLLMInput(compact, scratch);
+            do_not_optimize(scratch.inputIds.data());
+        }
+    });
+    add("preprocess/llm_copy_struct_512", 3 * 512 * sizeof(int64_t), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            LLMPreprocessedInput copy = llm_input;
+            do_not_optimize(copy);
+        }
+    });
+
+    SequencePacker packer;
+    add("preprocess/llm_sequence_pack_8x300", 0, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            packer.reset(512);
+            for (size_t q = 0; q < 8; ++q) {
+                const size_t length = 40 + q * 30;
+                packer.add(q, llm_input.input_ids.data(), llm_input.token_type_ids.data(), length);
+            }
+            do_not_optimize(packer.size());
+        }
+    });
+
+    // --- Segmentation post-processing: 1/8-resolution logits -> 520 x 520 ---
+    std::vector<float> seg_low_res(21 * 65 * 65);
+    for (size_t i = 0; i < seg_low_res.size(); ++i) seg_low_res[i] = static_cast<float>((i * 2654435761u) % 1000) / 1000.0f;
+    UpsampleArgmax upsampler(21, 65, 65, 520, 520);
+    UpsampleScratch upsample_scratch;
+    std::vector<int32_t> seg_labels(520 * 520);
+    std::vector<float> seg_scores(SEG_OUTPUT);
+    add("postprocess/seg_upsample_argmax_65_to_520", seg_low_res.size() * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            upsampler.toLabels(seg_low_res.data(), seg_labels.data(), upsample_scratch);
+            do_not_optimize(seg_labels.data());
+        }
+    });
+    add("postprocess/seg_upsample_argmax_onehot_65_to_520", SEG_OUTPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            upsampler.toOneHotScores(seg_low_res.data(), seg_scores.data(), upsample_scratch);
+            do_not_optimize(seg_scores.data());
+        }
+    });
+
+    // --- YOLO output decoding (confidence 0.25, before NMS) ---
+    constexpr size_t YOLOV8_OUTPUT = 84 * 8400;
+    std::vector<float> yolov8_output(YOLOV8_OUTPUT), yolov8_transposed(YOLOV8_OUTPUT);
+    for (size_t i = 0; i < YOLOV8_OUTPUT; ++i) {
+        const float r = static_cast<float>((i * 2654435761u) % 1000) / 1000.0f;
+        yolov8_output[i] = i < 4 * 8400 ? r * 640 : r * r * r * r;
+    }
+    std::vector<float> yolov5_output(DET_OUTPUT);
+    for (size_t i = 0; i < DET_OUTPUT; ++i) {
+        const float r = static_cast<float>((i * 2654435761u) % 1000) / 1000.0f;
+        yolov5_output[i] = i % 85 < 4 ? r * 640 : r * r * r * r;
+    }
+    YoloDecoder yolov8_decoder(detectYoloLayout({1, 84, 8400}));
+    YoloDecoder yolov5_decoder(detectYoloLayout({1, 25200, 85}));
+    std::vector<YoloDetection> yolo_boxes;
+    add("postprocess/yolo_decode_channel_major_84x8400", YOLOV8_OUTPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            yolov8_decoder.decode(yolov8_output.data(), 0.25f, yolo_boxes);
+            do_not_optimize(yolo_boxes.data());
+        }
+    });
+    add("postprocess/yolo_transpose_84x8400", YOLOV8_OUTPUT * sizeof(float), [&](size_t n) { // the copy the decoder avoids
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t c = 0; c < 84; ++c)
+                for (size_t a = 0; a < 8400; ++a) yolov8_transposed[a * 84 + c] = yolov8_output[c * 8400 + a];
+            do_not_optimize(yolov8_transposed.data());
+        }
+    });
+    add("postprocess/yolo_decode_anchor_major_25200x85", DET_OUTPUT * sizeof(float), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            yolov5_decoder.decode(yolov5_output.data(), 0.25f, yolo_boxes);
+            do_not_optimize(yolo_boxes.data());
+        }
+    });
+
+    // --- BoundedTSQueue (ns per item) ---
+    add("queue/bounded_1p1c_cap8", 0, queue_case(1, 1, 8));
+    add("queue/bounded_1p1c_cap1024", 0, queue_case(1, 1, 1024));
+    add("queue/bounded_4p4c_cap64", 0, queue_case(4, 4, 64));
+    add("queue/bounded_batch16_1p1c_cap64", 0, batch_queue_case(1, 16, 64));
+    add("queue/bounded_batch16_4p1c_cap64", 0, batch_queue_case(4, 16, 64));
+
+    // --- NMS decoding (parse_nms_data) ---
+    const std::vector<uint8_t> nms_sparse = make_nms_buffer(80, 1);
+    const std::vector<uint8_t> nms_full = make_nms_buffer(80, 100);
+    NmsDetections detections;
+    detections.reserve(80, 100);
+    std::vector<Coco17DetectionResult> coco;
+    coco.reserve(80 * 100);
+    add("nms/decode_soa_80x1", nms_sparse.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            decode_nms(nms_sparse.data(), 80, detections, nms_sparse.size());
+            do_not_optimize(detections.count);
+        }
+    });
+    add("nms/decode_soa_80x100", nms_full.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            decode_nms(nms_full.data(), 80, detections, nms_full.size());
+            do_not_optimize(detections.count);
+        }
+    });
+    add("nms/decode_coco_80x100", nms_full.size(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            decode_nms_to_coco(nms_full.data(), 80, 1280, 720, coco, nms_full.size());
+            do_not_optimize(coco.data());
+        }
+    });
+
+    if (json) {
+        std::ostringstream out;
+        out << "{\n  \"benchmark\": \"interface_hotpath_bench\",\n  \"min_time_ms\": " << options.min_time_ms
+            << ",\n  \"repetitions\": " << options.repetitions << ",\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const CaseResult &r = results[i];
+            out << (i ? "," : "") << "\n    {\"name\": \"" << json_escape(r.name) << "\", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op_median << ", \"ns_per_op_min\": " << r.ns_per_op_min
+                << ", \"bytes_per_op\": " << r.bytes_per_op << "}";
+        }
+        out << "\n  ]\n}\n";
+        std::cout << out.str();
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Runs the MLPerf-style load scenarios against the synthetic submitter, so the scenario logic and
+// the harness overhead can be checked without a model or an accelerator.
+//
+//   ./load_scenarios_bench -scenario=SingleStream -compute-us=2000
+//   ./load_scenarios_bench -scenario=Server -qps=400 -latency-bound-ms=20 -outstanding=8 -compute-us=10000
+//   ./load_scenarios_bench -scenario=Offline -queries=4096 -batch=64 -batch-us=500 -compute-us=300 -format=json
+#include "load_scenarios.hpp"
+#include "synthetic_submitter.hpp"
+
+#include <iostream>
+#include <string>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+int main(int argc, char *argv[])
+{
+    SyntheticSubmitterConfig submitter;
+    submitter.per_query.distribution = SyntheticDistribution::LogNormal;
+    submitter.per_query.mean = std::chrono::microseconds(std::stol(get_option(argc, argv, "-compute-us", "2000")));
+    submitter.per_query.spread = std::chrono::microseconds(std::stol(get_option(argc, argv, "-spread-us", "200")));
+    submitter.per_batch.mean = std::chrono::microseconds(std::stol(get_option(argc, argv, "-batch-us", "0")));
+    submitter.input_elements = 16;     // the runner copies samples into every query; keep them small
+    submitter.output_shape = {1, 1000};
+
+    LoadScenarioConfig config;
+    config.scenario = parse_load_scenario(get_option(argc, argv, "-scenario", "SingleStream"));
+    config.min_queries = std::stoul(get_option(argc, argv, "-queries", "256"));
+    config.min_duration = std::chrono::milliseconds(std::stol(get_option(argc, argv, "-min-duration-ms", "1000")));
+    config.samples_per_query = std::stoul(get_option(argc, argv, "-samples-per-query", "8"));
+    config.target_qps = std::stod(get_option(argc, argv, "-qps", "100"));
+    config.latency_bound = std::chrono::milliseconds(std::stol(get_option(argc, argv, "-latency-bound-ms", "100")));
+    config.max_outstanding = std::stoul(get_option(argc, argv, "-outstanding", "16"));
+    config.offline_batch_size = std::stoul(get_option(argc, argv, "-batch", "0"));
+
+    auto interface = std::make_shared<Synthetic_Submitter_Implementation>(submitter);
+    interface->initialize("");
+    std::vector<VariantType> samples;
+    for (int i = 0; i < 16; ++i) samples.push_back(interface->preprocessVisionData("sample_" + std::to_string(i)));
+
+    LoadScenarioRunner runner(interface, samples);
+    LoadScenarioResult result = runner.run(config);
+    if (get_option(argc, argv, "-format", "text") == "json") {
+        std::cout << load_scenario_result_to_json(result) << std::endl;
+    } else {
+        print_load_scenario_result(result);
+    }
+    return result.valid ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Runs the memory-profiling decorator over the synthetic submitter with allocation counting compiled
+// in, so the per-phase report can be checked without a model. Fails if plain or over-aligned
+// allocations are not counted.
+//
+//   ./memory_profiler_bench -task=segmentation -queries=64
+//   ./memory_profiler_bench -task=classification -queries=1000 -report=memory_report.json
+#include "memory_profiler.hpp"
+#include "synthetic_submitter.hpp"
+
+#include <iostream>
+#include <string>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+struct alignas(64) CacheLineBlock {
+    float values[16];
+};
+
+// Keeps the compiler from eliding a new/delete pair.
+static void *volatile g_sink;
+
+// Allocation count and bytes of one call to `fn`, as seen through take_memory_snapshot().
+template <typename Fn>
+static std::pair<uint64_t, uint64_t> count_allocations(Fn &&fn)
+{
+    const MemorySnapshot before = take_memory_snapshot();
+    fn();
+    const MemorySnapshot after = take_memory_snapshot();
+    return {after.alloc_count - before.alloc_count, after.alloc_bytes - before.alloc_bytes};
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string task = get_option(argc, argv, "-task", "segmentation");
+    const size_t queries = std::stoul(get_option(argc, argv, "-queries", "64"));
+    const std::string report_path = get_option(argc, argv, "-report", "");
+
+    bool ok = allocation_counting_enabled();
+    if (!ok) std::cerr << "memory_profiler.cpp was built without AI_BMT_COUNT_ALLOCATIONS" << std::endl;
+
+    const auto plain = count_allocations([] {
+        g_sink = new float[256];
+        delete[] static_cast<float *>(g_sink);
+    });
+    const auto aligned = count_allocations([] {
+        g_sink = new CacheLineBlock;
+        delete static_cast<CacheLineBlock *>(g_sink);
+        g_sink = new CacheLineBlock[4];
+        delete[] static_cast<CacheLineBlock *>(g_sink);
+    });
+    if (plain.first < 1 || plain.second < 256 * sizeof(float)) {
+        std::cerr << "plain allocations are not counted" << std::endl;
+        ok = false;
+    }
+    if (aligned.first < 2 || aligned.second < 5 * sizeof(CacheLineBlock)) {
+        std::cerr << "over-aligned allocations are not counted" << std::endl;
+        ok = false;
+    }
+
+    SyntheticSubmitterConfig config;
+    config.type = task == "classification" ? InterfaceType::ImageClassification
+                : task == "detection"      ? InterfaceType::ObjectDetection
+                                           : InterfaceType::SemanticSegmentation;
+    config.per_query.mean = std::chrono::microseconds(0);
+
+    auto profiled = std::make_shared<Memory_Profiling_Submitter_Implementation>(
+        std::make_shared<Synthetic_Submitter_Implementation>(config), report_path);
+    profiled->initialize("");
+    for (size_t i = 0; i < queries; ++i) {
+        std::vector<VariantType> batch{profiled->preprocessVisionData("synthetic_" + std::to_string(i))};
+        std::vector<BMTVisionResult> results = profiled->inferVision(batch);
+    }
+
+    const MemoryReport report = profiled->get_report();
+    print_memory_report(report);
+    if (report.phase(MemoryPhase::Infer).alloc_count < queries) {
+        std::cerr << "inference allocations are missing from the report" << std::endl;
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
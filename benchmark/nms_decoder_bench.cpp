@@ -0,0 +1,179 @@
+// Checks decode_nms and decode_nms_to_coco against the reference walk of parse_nms_data on known
+// HailoRT NMS-by-class buffers (regular, empty classes, truncated, corrupt counts, over capacity),
+// then times the decoders. parse_nms_data itself lives in utils.cpp with the HailoRT and OpenCV
+// helpers, so its loop is reproduced here as the reference. Exits with status 1 on any mismatch.
+//
+//   ./nms_decoder_bench
+//   ./nms_decoder_bench -classes=80 -per-class=100 -iterations=20000
+#include "nms_decoder.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+// A detection as parse_nms_data returns it: 1-based class id and the raw box.
+struct ReferenceBox {
+    size_t class_id;
+    NmsBox box;
+};
+
+// The walk of parse_nms_data (utils.cpp) before the shared decoder, bounded by the buffer size.
+static std::vector<ReferenceBox> reference_parse_nms_data(const std::vector<uint8_t> &buffer, size_t max_class_count)
+{
+    std::vector<ReferenceBox> boxes;
+    size_t offset = 0;
+    for (size_t class_id = 0; class_id < max_class_count; class_id++) {
+        if (offset + sizeof(float) > buffer.size()) break;
+        float count;
+        std::memcpy(&count, buffer.data() + offset, sizeof(float));
+        offset += sizeof(float);
+        for (size_t j = 0; j < static_cast<size_t>(count); j++) {
+            if (offset + sizeof(NmsBox) > buffer.size()) return boxes;
+            ReferenceBox named;
+            std::memcpy(&named.box, buffer.data() + offset, sizeof(NmsBox));
+            named.class_id = class_id + 1;
+            offset += sizeof(NmsBox);
+            boxes.push_back(named);
+        }
+    }
+    return boxes;
+}
+
+static void append_float(std::vector<uint8_t> &buffer, float value)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(float));
+}
+
+// `counts[c]` boxes for class slot c, with coordinates and scores that differ per box.
+static std::vector<uint8_t> make_buffer(const std::vector<size_t> &counts)
+{
+    std::vector<uint8_t> buffer;
+    for (size_t c = 0; c < counts.size(); ++c) {
+        append_float(buffer, static_cast<float>(counts[c]));
+        for (size_t b = 0; b < counts[c]; ++b) {
+            const float base = 0.01f * static_cast<float>((c * 7 + b * 3) % 50);
+            NmsBox box{base, base + 0.1f, base + 0.3f, base + 0.45f, 0.5f + 0.004f * static_cast<float>(b % 100)};
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&box);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(NmsBox));
+        }
+    }
+    return buffer;
+}
+
+static size_t failures = 0;
+
+static void fail(const std::string &name, const std::string &what)
+{
+    std::cerr << "  FAIL " << name << ": " << what << std::endl;
+    failures++;
+}
+
+static bool same(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-4f * std::max(1.0f, std::fabs(b));
+}
+
+// Decodes `buffer` both ways and compares with the reference. `capacity` limits the output buffers.
+static void check_case(const std::string &name, const std::vector<uint8_t> &buffer, size_t max_class_count,
+                       const std::vector<ReferenceBox> &expected, size_t capacity)
+{
+    const size_t kept = std::min(capacity, expected.size());
+
+    NmsDetections detections;
+    detections.reserve(capacity, 1);
+    const NmsDecodeResult soa = decode_nms(buffer.data(), max_class_count, detections, buffer.size());
+    if (soa.decoded != kept || detections.count != kept || soa.dropped != expected.size() - kept) {
+        fail(name, "decode_nms decoded " + std::to_string(soa.decoded) + ", dropped " + std::to_string(soa.dropped) +
+                   ", expected " + std::to_string(kept) + " and " + std::to_string(expected.size() - kept));
+    }
+    for (size_t i = 0; i < std::min(kept, detections.count); ++i) {
+        const ReferenceBox &e = expected[i];
+        if (detections.class_id[i] + 1u != e.class_id || !same(detections.x_min[i], e.box.x_min) ||
+            !same(detections.y_min[i], e.box.y_min) || !same(detections.x_max[i], e.box.x_max) ||
+            !same(detections.y_max[i], e.box.y_max) || !same(detections.score[i], e.box.score)) {
+            fail(name, "decode_nms detection " + std::to_string(i) + " differs");
+            break;
+        }
+    }
+
+    const float width = 1280, height = 720;
+    std::vector<Coco17DetectionResult> coco;
+    coco.reserve(capacity);
+    const NmsDecodeResult scaled = decode_nms_to_coco(buffer.data(), max_class_count, width, height, coco, buffer.size());
+    if (scaled.decoded != kept || coco.size() != kept || scaled.dropped != expected.size() - kept) {
+        fail(name, "decode_nms_to_coco decoded " + std::to_string(scaled.decoded) + ", expected " + std::to_string(kept));
+    }
+    for (size_t i = 0; i < std::min(kept, coco.size()); ++i) {
+        const ReferenceBox &e = expected[i];
+        const Coco17DetectionResult &r = coco[i];
+        if (static_cast<size_t>(r.classIndex) + 1 != e.class_id || !same(r.top_left_x, e.box.x_min * width) ||
+            !same(r.top_left_y, e.box.y_min * height) || !same(r.width, (e.box.x_max - e.box.x_min) * width) ||
+            !same(r.height, (e.box.y_max - e.box.y_min) * height) || !same(r.confidence, e.box.score)) {
+            fail(name, "decode_nms_to_coco detection " + std::to_string(i) + " differs");
+            break;
+        }
+    }
+    std::cout << "  " << name << ": " << kept << " detections" << (kept < expected.size() ? " (over capacity)" : "") << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t classes = std::stoul(get_option(argc, argv, "-classes", "80"));
+    const size_t per_class = std::stoul(get_option(argc, argv, "-per-class", "100"));
+    const size_t iterations = std::stoul(get_option(argc, argv, "-iterations", "20000"));
+
+    std::cout << "NMS decoder vs parse_nms_data" << std::endl;
+    std::vector<size_t> counts(80);
+    for (size_t c = 0; c < counts.size(); ++c) counts[c] = (c * 5) % 7; // several classes have no boxes
+    const std::vector<uint8_t> regular = make_buffer(counts);
+    const std::vector<ReferenceBox> reference = reference_parse_nms_data(regular, 80);
+    check_case("regular", regular, 80, reference, 80 * 6);
+    check_case("over capacity", regular, 80, reference, 10);
+    check_case("fewer class slots", regular, 12, reference_parse_nms_data(regular, 12), 80 * 6);
+
+    std::vector<uint8_t> truncated(regular.begin(), regular.begin() + regular.size() / 2 + 3);
+    check_case("truncated", truncated, 80, reference_parse_nms_data(truncated, 80), 80 * 6);
+
+    // Corrupt counts end the walk at the class that carries them; the classes before it still decode.
+    const std::pair<const char *, float> corrupt_counts[] = {{"negative count", -3.0f}, {"NaN count", std::nanf("")}, {"huge count", 1e30f}};
+    for (const auto &corrupt : corrupt_counts) {
+        std::vector<uint8_t> buffer = make_buffer({2, 1});
+        append_float(buffer, corrupt.second);
+        const std::vector<uint8_t> valid = make_buffer({2, 1});
+        check_case(corrupt.first, buffer, 80, reference_parse_nms_data(valid, 2), 80 * 6);
+    }
+
+    const std::vector<uint8_t> full = make_buffer(std::vector<size_t>(classes, per_class));
+    NmsDetections detections;
+    detections.reserve(classes, per_class);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) decode_nms(full.data(), classes, detections, full.size());
+    const double soa_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    std::vector<Coco17DetectionResult> coco;
+    coco.reserve(classes * per_class);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) decode_nms_to_coco(full.data(), classes, 1280, 720, coco, full.size());
+    const double coco_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    std::cout << classes << " x " << per_class << " boxes: decode_nms " << soa_ns / 1000 << " us, decode_nms_to_coco "
+              << coco_ns / 1000 << " us (" << detections.count << " detections)" << std::endl;
+
+    if (failures > 0) {
+        std::cerr << failures << " NMS decoding checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
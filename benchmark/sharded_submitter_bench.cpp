@@ -0,0 +1,122 @@
+// Runs Sharded_Submitter_Implementation over synthetic shards, so dispatch, result ordering and
+// scaling can be checked on a plain host without a model or an accelerator. Each query's result
+// echoes its input, and the run fails if any result comes back out of order.
+//
+//   ./sharded_submitter_bench -shards=4 -batches=32 -batch=64 -compute-us=1000
+//   ./sharded_submitter_bench -shards=4 -input=view -compute-us=0      dispatch overhead, no copies
+#include "sharded_submitter.hpp"
+#include "synthetic_submitter.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+// Synthetic shard whose first class score is the first input value, accepting vector<float> queries
+// and the float* views of ShardInput::View.
+class Echo_Submitter_Implementation : public Synthetic_Submitter_Implementation
+{
+public:
+    using Synthetic_Submitter_Implementation::Synthetic_Submitter_Implementation;
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        vector<BMTVisionResult> results = Synthetic_Submitter_Implementation::inferVision(data);
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (const auto *view = std::get_if<float *>(&data[i])) {
+                results[i].classProbabilities[0] = **view;
+            } else {
+                results[i].classProbabilities[0] = std::get<std::vector<float>>(data[i]).front();
+            }
+        }
+        return results;
+    }
+};
+
+struct RunResult {
+    double seconds = 0;
+    size_t misordered = 0;
+    std::vector<ShardStats> shards;
+};
+
+static RunResult run(const SyntheticSubmitterConfig &config, size_t shard_count, ShardInput input,
+                     const std::vector<VariantType> &batch, size_t batches)
+{
+    std::vector<std::shared_ptr<AI_BMT_Interface>> instances;
+    for (size_t i = 0; i < shard_count; ++i) instances.push_back(std::make_shared<Echo_Submitter_Implementation>(config));
+    Sharded_Submitter_Implementation sharded(std::move(instances));
+    sharded.set_input_mode(input);
+    sharded.initialize("");
+
+    RunResult result;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < batches; ++b) {
+        std::vector<BMTVisionResult> results = sharded.inferVision(batch);
+        if (results.size() != batch.size()) {
+            result.misordered += batch.size();
+            continue;
+        }
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].classProbabilities[0] != static_cast<float>(i)) result.misordered++;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.shards = sharded.get_shard_stats();
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t shard_count = std::stoul(get_option(argc, argv, "-shards", "4"));
+    const size_t batches = std::stoul(get_option(argc, argv, "-batches", "32"));
+    const size_t batch_size = std::stoul(get_option(argc, argv, "-batch", "64"));
+    const size_t input_elements = std::stoul(get_option(argc, argv, "-input-elements", "150528")); // 3 x 224 x 224
+    const ShardInput input = get_option(argc, argv, "-input", "copy") == "view" ? ShardInput::View : ShardInput::Copy;
+
+    SyntheticSubmitterConfig config;
+    config.per_query.mean = std::chrono::microseconds(std::stol(get_option(argc, argv, "-compute-us", "1000")));
+    config.output_shape = {1, 1000};
+
+    std::vector<VariantType> batch;
+    for (size_t i = 0; i < batch_size; ++i) {
+        std::vector<float> query(input_elements);
+        query[0] = static_cast<float>(i);
+        batch.push_back(std::move(query));
+    }
+
+    const RunResult single = run(config, 1, input, batch, batches);
+    const RunResult sharded = run(config, shard_count, input, batch, batches);
+    const double queries = static_cast<double>(batches * batch_size);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "input " << (ShardInput::View == input ? "view" : "copy") << ", " << batches << " batches of " << batch_size
+              << " queries, " << config.per_query.mean.count() << " us per query" << std::endl;
+    std::cout << "  1 shard : " << queries / single.seconds << " queries/s, "
+              << 1e6 * single.seconds / queries << " us per query" << std::endl;
+    std::cout << "  " << shard_count << " shards: " << queries / sharded.seconds << " queries/s, "
+              << 1e6 * sharded.seconds / queries << " us per query, speedup "
+              << std::setprecision(2) << single.seconds / sharded.seconds << "x" << std::endl;
+    std::cout << std::setprecision(1);
+    for (size_t i = 0; i < sharded.shards.size(); ++i) {
+        std::cout << "    shard " << i << ": " << sharded.shards[i].queries << " queries, "
+                  << sharded.shards[i].dispatches << " dispatches, busy " << 1e3 * sharded.shards[i].busy_seconds << " ms" << std::endl;
+    }
+
+    const size_t misordered = single.misordered + sharded.misordered;
+    if (misordered > 0) {
+        std::cerr << misordered << " results were missing or out of order" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Checks SysfsTelemetrySource against fake /sys and /proc trees written to a temporary directory, so
+// the frequency, temperature and throttle parsing is verified on any host, then prints one live
+// sample of this machine. Exits with status 1 if a parsed value does not match the fake tree.
+//
+//   ./thermal_telemetry_bench
+//   ./thermal_telemetry_bench -sys=/sys -proc=/proc       live sample from other roots
+#include "thermal_telemetry.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+static void write_file(const std::filesystem::path &path, const std::string &content)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << content << "\n";
+}
+
+static size_t failures = 0;
+
+static void expect(const std::string &what, double actual, double expected)
+{
+    if (std::fabs(actual - expected) > 1e-6) {
+        std::cerr << "  FAIL " << what << ": got " << actual << ", expected " << expected << std::endl;
+        failures++;
+    }
+}
+
+static void print_sample(const std::string &label, const TelemetrySample &s)
+{
+    std::cout << label << ": freq mean " << s.freq_mean_mhz << " MHz, min " << s.freq_min_mhz << " MHz, hw max "
+              << s.freq_hw_max_mhz << " MHz, cap " << s.freq_cap_mhz << " MHz, temperature "
+              << (s.has_temperature ? std::to_string(s.temperature_c) + " C" : std::string("n/a"))
+              << ", throttle count " << s.throttle_count << std::endl;
+}
+
+// Two CPUs with cpufreq and x86 throttle counters (cpu2 is offline and must be ignored), two
+// thermal zones and a third that is powered down (unreadable value).
+static void check_cpufreq_tree(const std::filesystem::path &root)
+{
+    const std::filesystem::path cpu = root / "sys/devices/system/cpu";
+    write_file(cpu / "online", "0-1");
+    write_file(cpu / "cpu0/cpufreq/scaling_cur_freq", "2000000");
+    write_file(cpu / "cpu0/cpufreq/cpuinfo_max_freq", "3000000");
+    write_file(cpu / "cpu0/cpufreq/scaling_max_freq", "2500000");
+    write_file(cpu / "cpu0/thermal_throttle/core_throttle_count", "3");
+    write_file(cpu / "cpu0/thermal_throttle/package_throttle_count", "4");
+    write_file(cpu / "cpu1/cpufreq/scaling_cur_freq", "1000000");
+    write_file(cpu / "cpu1/cpufreq/cpuinfo_max_freq", "3200000");
+    write_file(cpu / "cpu1/cpufreq/scaling_max_freq", "3200000");
+    write_file(cpu / "cpu1/thermal_throttle/core_throttle_count", "2");
+    write_file(cpu / "cpu2/cpufreq/scaling_cur_freq", "100000");
+    write_file(cpu / "cpu2/thermal_throttle/core_throttle_count", "100");
+    const std::filesystem::path thermal = root / "sys/class/thermal";
+    write_file(thermal / "thermal_zone0/temp", "45000");
+    write_file(thermal / "thermal_zone1/temp", "61500");
+    write_file(thermal / "thermal_zone2/temp", "unavailable");
+    write_file(root / "proc/cpuinfo", "cpu MHz\t\t: 999.000");
+
+    SysfsTelemetrySource source((root / "sys").string(), (root / "proc").string());
+    const TelemetrySample first = source.read();
+    print_sample("fake cpufreq tree", first);
+    expect("freq_mean_mhz", first.freq_mean_mhz, 1500);
+    expect("freq_min_mhz", first.freq_min_mhz, 1000);
+    expect("freq_hw_max_mhz", first.freq_hw_max_mhz, 3200);
+    expect("freq_cap_mhz", first.freq_cap_mhz, 2500);
+    expect("has_temperature", first.has_temperature, 1);
+    expect("temperature_c", first.temperature_c, 61.5);
+    expect("throttle_count", static_cast<double>(first.throttle_count), 9);
+
+    // Files are re-read on every sample: the counters rise and the run is reported as throttled.
+    write_file(cpu / "cpu0/thermal_throttle/core_throttle_count", "8");
+    write_file(thermal / "thermal_zone0/temp", "83250");
+    TelemetrySample second = source.read();
+    second.t = 1;
+    expect("temperature_c after update", second.temperature_c, 83.25);
+    expect("throttle_count after update", static_cast<double>(second.throttle_count), 14);
+
+    const TelemetryReport report = correlate_telemetry({first, second}, {});
+    expect("report.throttle_events", static_cast<double>(report.throttle_events), 5);
+    expect("report.peak_temperature_c", report.peak_temperature_c, 83.25);
+    expect("report.frequency_capped", report.frequency_capped, 1);
+    expect("report.throttled", report.throttled, 1);
+}
+
+// A VM without cpufreq or thermal zones: frequencies come from /proc/cpuinfo.
+static void check_cpuinfo_tree(const std::filesystem::path &root)
+{
+    write_file(root / "sys/devices/system/cpu/online", "0-1");
+    write_file(root / "proc/cpuinfo", "processor\t: 0\ncpu MHz\t\t: 2400.000\n\nprocessor\t: 1\ncpu MHz\t\t: 1800.500");
+
+    SysfsTelemetrySource source((root / "sys").string(), (root / "proc").string());
+    const TelemetrySample sample = source.read();
+    print_sample("fake cpuinfo tree", sample);
+    expect("cpuinfo freq_mean_mhz", sample.freq_mean_mhz, 2100.25);
+    expect("cpuinfo freq_min_mhz", sample.freq_min_mhz, 1800.5);
+    expect("cpuinfo freq_hw_max_mhz", sample.freq_hw_max_mhz, 0);
+    expect("cpuinfo has_temperature", sample.has_temperature, 0);
+    expect("cpuinfo throttle_count", static_cast<double>(sample.throttle_count), 0);
+}
+
+int main(int argc, char *argv[])
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() /
+                                       ("thermal_telemetry_bench_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::remove_all(root);
+    check_cpufreq_tree(root / "cpufreq");
+    check_cpuinfo_tree(root / "cpuinfo");
+    std::filesystem::remove_all(root);
+
+    SysfsTelemetrySource live(get_option(argc, argv, "-sys", "/sys"), get_option(argc, argv, "-proc", "/proc"));
+    print_sample("this host", live.read());
+
+    if (failures > 0) {
+        std::cerr << failures << " telemetry values did not match the fake trees" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+// Checks WorkStealingPool (utils/work_stealing_pool.hpp) on a plain host: task results, stealing
+// between workers, priority and deadline ordering, deadline-miss accounting, nested wait() from
+// inside tasks, and batch splitting in Pooled_Submitter_Implementation. Then times task dispatch
+// from outside and from inside the pool. Exits with status 1 if any check fails.
+//
+//   ./work_stealing_pool_bench
+//   ./work_stealing_pool_bench -workers=8 -tasks=200000
+#include "work_stealing_pool.hpp"
+#include "synthetic_submitter.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static std::string get_option(int argc, char *argv[], const std::string &option, const std::string &fallback)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (0 == arg.find(option + "=")) {
+            return arg.substr(option.size() + 1);
+        }
+    }
+    return fallback;
+}
+
+static size_t failures = 0;
+
+static void expect(const std::string &what, bool ok)
+{
+    if (!ok) {
+        std::cerr << "  FAIL " << what << std::endl;
+        failures++;
+    }
+}
+
+// A worker counts a task as executed just after running it, so the counters can trail the futures.
+static WorkStealingStats settled_stats(WorkStealingPool &pool, size_t executed)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    WorkStealingStats stats = pool.get_stats();
+    while (stats.executed < executed && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stats = pool.get_stats();
+    }
+    return stats;
+}
+
+// Keeps the only worker of a one-worker pool busy until release(), so tasks can be queued behind it.
+class Blocker
+{
+private:
+    std::promise<void> gate;
+    std::future<void> done;
+
+public:
+    explicit Blocker(WorkStealingPool &pool)
+    {
+        std::shared_future<void> opened = gate.get_future().share();
+        std::promise<void> started;
+        std::future<void> running = started.get_future();
+        done = pool.submit([opened, &started] {
+            started.set_value();
+            opened.wait();
+        });
+        running.wait();
+    }
+
+    void release()
+    {
+        gate.set_value();
+        done.wait();
+    }
+};
+
+static void check_results()
+{
+    WorkStealingPool pool(4);
+    std::vector<std::future<size_t>> futures;
+    for (size_t i = 0; i < 1000; ++i) futures.push_back(pool.submit([i] { return i * i; }));
+    size_t wrong = 0;
+    for (size_t i = 0; i < futures.size(); ++i) {
+        if (pool.wait(futures[i]) != i * i) wrong++;
+    }
+    expect("every submit() returns its own result", 0 == wrong);
+
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+    bool rethrown = false;
+    try {
+        pool.wait(failing);
+    }
+    catch (const std::runtime_error &) {
+        rethrown = true;
+    }
+    expect("a task's exception reaches wait()", rethrown);
+    expect("executed counts every task", settled_stats(pool, 1001).executed == 1001);
+    std::cout << "  results: 1000 tasks, exception propagated" << std::endl;
+}
+
+// Tasks posted from a worker land in its own deque; the idle workers can only get them by stealing.
+static void check_stealing()
+{
+    const size_t workers = 4, tasks = 200;
+    WorkStealingPool pool(workers);
+    auto spawner = pool.submit([&pool] {
+        std::vector<std::future<void>> children;
+        for (size_t i = 0; i < tasks; ++i) {
+            children.push_back(pool.submit([] { std::this_thread::sleep_for(std::chrono::microseconds(200)); }));
+        }
+        for (auto &child : children) pool.wait(child);
+    });
+    pool.wait(spawner);
+
+    const WorkStealingStats stats = settled_stats(pool, tasks + 1);
+    size_t active = 0;
+    for (size_t executed : stats.executed_per_worker) active += executed > 0 ? 1 : 0;
+    expect("idle workers steal from the spawning worker", stats.stolen > 0);
+    expect("stolen tasks run on more than one worker", active > 1);
+    std::cout << "  stealing: " << stats.stolen << " of " << tasks << " tasks stolen, " << active << " of "
+              << workers << " workers ran tasks" << std::endl;
+}
+
+// One worker, blocked while tasks of every level are queued: deadline tasks run first (earliest
+// deadline first), then High, Normal and Low.
+static void check_priorities()
+{
+    WorkStealingPool pool(1);
+    Blocker blocker(pool);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string &name) {
+        return [&mutex, &order, name] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+    const auto now = WorkStealingPool::Clock::now();
+    pool.post(record("low"), TaskHints{TaskPriority::Low});
+    pool.post(record("normal"), TaskHints{TaskPriority::Normal});
+    pool.post(record("high"), TaskHints{TaskPriority::High});
+    pool.post(record("deadline+2s"), TaskHints{TaskPriority::Low, now + std::chrono::seconds(2)});
+    pool.post(record("deadline+1s"), TaskHints{TaskPriority::Low, now + std::chrono::seconds(1)});
+    pool.post(record("high"), TaskHints{TaskPriority::High});
+    pool.post(record("low"), TaskHints{TaskPriority::Low});
+    blocker.release();
+    settled_stats(pool, 8);
+
+    const std::vector<std::string> expected = {"deadline+1s", "deadline+2s", "high", "high", "normal", "low", "low"};
+    std::lock_guard<std::mutex> lock(mutex);
+    expect("deadline, then High, Normal and Low order", order == expected);
+    std::string ran;
+    for (const auto &name : order) ran += (ran.empty() ? "" : ", ") + name;
+    std::cout << "  priorities: " << ran << std::endl;
+}
+
+// A deadline task that starts after its deadline counts as a miss; one that starts in time does not.
+static void check_deadline_misses()
+{
+    WorkStealingPool pool(1);
+    Blocker blocker(pool);
+    const auto now = WorkStealingPool::Clock::now();
+    pool.post([] {}, TaskHints{TaskPriority::Normal, now + std::chrono::milliseconds(1)});
+    pool.post([] {}, TaskHints{TaskPriority::Normal, now + std::chrono::seconds(60)});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    blocker.release();
+
+    const WorkStealingStats stats = settled_stats(pool, 3);
+    expect("deadline_tasks counts both deadline tasks", stats.deadline_tasks == 2);
+    expect("only the late task is a deadline miss", stats.deadline_misses == 1);
+    std::cout << "  deadlines: " << stats.deadline_tasks << " tasks, " << stats.deadline_misses << " missed" << std::endl;
+}
+
+static size_t nested_sum(WorkStealingPool &pool, size_t depth)
+{
+    if (0 == depth) return 1;
+    auto left = pool.submit([&pool, depth] { return nested_sum(pool, depth - 1); });
+    auto right = pool.submit([&pool, depth] { return nested_sum(pool, depth - 1); });
+    return pool.wait(left) + pool.wait(right);
+}
+
+// Tasks that wait for their own subtasks: with one or two workers every level of the tree blocks a
+// worker, so this only finishes if wait() runs other tasks meanwhile.
+static void check_nested_wait()
+{
+    const size_t depth = 8;
+    for (size_t workers : {1, 2}) {
+        WorkStealingPool pool(workers);
+        auto root = pool.submit([&pool] { return nested_sum(pool, depth); });
+        if (std::future_status::ready != root.wait_for(std::chrono::seconds(30))) {
+            std::cerr << "  FAIL nested wait() deadlocked with " << workers << " worker(s)" << std::endl;
+            std::exit(1); // the pool cannot be joined
+        }
+        expect("nested wait() returns the subtask results", root.get() == (size_t{1} << depth));
+        std::cout << "  nested wait: " << (size_t{1} << (depth + 1)) - 1 << " tasks on " << workers << " worker(s)" << std::endl;
+    }
+}
+
+// Synthetic submitter whose first class score is the query's first input value.
+class Echo_Submitter_Implementation : public Synthetic_Submitter_Implementation
+{
+public:
+    using Synthetic_Submitter_Implementation::Synthetic_Submitter_Implementation;
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        vector<BMTVisionResult> results = Synthetic_Submitter_Implementation::inferVision(data);
+        for (size_t i = 0; i < results.size(); ++i) results[i].classProbabilities[0] = std::get<std::vector<float>>(data[i]).front();
+        return results;
+    }
+};
+
+// A batch split into tasks of three queries comes back complete and in order.
+static void check_pooled_submitter()
+{
+    SyntheticSubmitterConfig config;
+    config.per_query.mean = std::chrono::microseconds(100);
+    config.input_elements = 4;
+    config.output_shape = {1, 10};
+    auto pool = std::make_shared<WorkStealingPool>(3);
+    Pooled_Submitter_Implementation pooled(std::make_shared<Echo_Submitter_Implementation>(config), pool,
+                                           TaskHints{TaskPriority::High}, 3);
+    pooled.initialize("");
+
+    std::vector<VariantType> batch;
+    for (size_t i = 0; i < 50; ++i) batch.push_back(std::vector<float>{static_cast<float>(i), 0, 0, 0});
+    const std::vector<BMTVisionResult> results = pooled.inferVision(batch);
+    size_t misordered = results.size() == batch.size() ? 0 : batch.size();
+    for (size_t i = 0; i < std::min(results.size(), batch.size()); ++i) {
+        if (results[i].classProbabilities[0] != static_cast<float>(i)) misordered++;
+    }
+    expect("Pooled_Submitter keeps results in query order", 0 == misordered);
+    std::cout << "  pooled submitter: " << results.size() << " results in " << (batch.size() + 2) / 3 << " tasks" << std::endl;
+}
+
+static double tasks_per_second(size_t workers, size_t tasks, bool from_worker)
+{
+    WorkStealingPool pool(workers);
+    std::atomic<size_t> counter{0};
+    auto start = std::chrono::steady_clock::now();
+    auto spawn = [&] {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks);
+        for (size_t i = 0; i < tasks; ++i) futures.push_back(pool.submit([&counter] { counter++; }));
+        for (auto &future : futures) pool.wait(future);
+    };
+    if (from_worker) {
+        auto root = pool.submit(spawn);
+        root.wait();
+    } else {
+        spawn();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    expect("every timed task ran", counter == tasks);
+    return tasks / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t workers = std::stoul(get_option(argc, argv, "-workers", "4"));
+    const size_t tasks = std::stoul(get_option(argc, argv, "-tasks", "100000"));
+
+    std::cout << "WorkStealingPool checks" << std::endl;
+    check_results();
+    check_stealing();
+    check_priorities();
+    check_deadline_misses();
+    check_nested_wait();
+    check_pooled_submitter();
+
+    std::cout << workers << " workers, " << tasks << " empty tasks: " << tasks_per_second(workers, tasks, false)
+              << " tasks/s posted from outside, " << tasks_per_second(workers, tasks, true)
+              << " tasks/s posted from a worker" << std::endl;
+
+    if (failures > 0) {
+        std::cerr << failures << " work-stealing pool checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
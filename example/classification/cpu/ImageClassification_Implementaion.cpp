@@ -10,6 +10,11 @@
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 #include <filesystem>
+#include "../../common/preprocess_pipeline.hpp"
+#include "../../common/ort_thread_placement.hpp"
+#include "../../common/ort_session_pool.hpp"
+#include "../../common/dataset_readahead.hpp"
+#include "../../common/vision_output_buffer.hpp"
 
 using namespace std;
 using namespace cv;
@@ -21,9 +26,12 @@ private:
     Env env;
     RunOptions runOptions;
     shared_ptr<Session> session;
+    unique_ptr<OrtSessionPool> sessionPool; // throughput mode (AI_BMT_ORT_REPLICAS > 1), otherwise null
     array<const char*, 1> inputNames;
     array<const char*, 1> outputNames;
     MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+    PreprocessEntry preprocessor; // resolved once in initialize()
+    shared_ptr<DatasetReadahead> readahead = datasetReadaheadFromEnvironment(); // AI_BMT_READAHEAD_LIST, otherwise null; shared per process
 
 public:
     virtual InterfaceType getInterfaceType() override
@@ -35,20 +43,37 @@ public:
     virtual void initialize(string modelPath) override
     {
         //session initializer
-        SessionOptions sessionOptions;
-        sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
-        sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        auto configure = [](SessionOptions& sessionOptions) {
+            sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+            sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        };
         wstring modelPathwstr(modelPath.begin(), modelPath.end());
-        session = make_shared<Session>(env, modelPathwstr.c_str(), sessionOptions);
+
+        // Throughput mode: N small single-threaded sessions fed concurrently instead of one wide one.
+        const OrtThroughputConfig throughput = ortThroughputConfigFromEnvironment();
+        sessionPool.reset();
+        session.reset();
+        if (throughput.enabled()) {
+            sessionPool = make_unique<OrtSessionPool>(env, modelPathwstr, throughput, configure);
+        }
+        else {
+            SessionOptions sessionOptions;
+            configure(sessionOptions);
+            applyOrtThreadPlacement(sessionOptions); // optional: AI_BMT_INFERENCE_CPUS=0-7
+            session = make_shared<Session>(env, modelPathwstr.c_str(), sessionOptions);
+        }
+        Session& firstSession = sessionPool ? sessionPool->session(0) : *session;
 
         // Get input and output names
         AllocatorWithDefaultOptions allocator;
-        AllocatedStringPtr inputName = session->GetInputNameAllocated(0, allocator);
-        AllocatedStringPtr outputName = session->GetOutputNameAllocated(0, allocator);
+        AllocatedStringPtr inputName = firstSession.GetInputNameAllocated(0, allocator);
+        AllocatedStringPtr outputName = firstSession.GetOutputNameAllocated(0, allocator);
         inputNames = { inputName.get() };
         outputNames = { outputName.get() };
         inputName.release();
         outputName.release();
+
+        preprocessor = selectPreprocessor(getInterfaceType(), modelPath);
     }
 
     virtual Optional_Data getOptionalData() override
@@ -69,70 +94,93 @@ public:
 
     virtual VariantType preprocessVisionData(const string& imagePath) override
     {
-        Mat image = imread(imagePath);
+        Mat image = loadImage(readahead.get(), imagePath);
         if (image.empty()) {
             throw runtime_error("Failed to load image: " + imagePath);
         }
 
-        // convert BGR to RGB before reshaping
-        cvtColor(image, image, cv::COLOR_BGR2RGB);
+        if (image.cols != preprocessor.width || image.rows != preprocessor.height) {
+            throw runtime_error("Unexpected image size (" + to_string(image.cols) + "x" + to_string(image.rows) + "): " + imagePath);
+        }
+
+        // BGR -> RGB, [0, 255] -> normalized float, HWC (224,224,3) -> CHW (3,224,224) in a single pass
+        vector<float> output(preprocessor.outputSize());
+        preprocessor.run(image.data, image.step, output.data());
+        return output;
+    }
 
-        // reshape (3D -> 1D)
-        image = image.reshape(1, 1);
+    // Runs one query; ORT writes the 1000 scores straight into `output` (a result vector or a driver buffer).
+    void runQuery(Session& runSession, const VariantType& query, float* output)
+    {
+        //onnx option setting
+        const array<int64_t, 4> inputShape = { 1, 3, 224, 224 };
+        const array<int64_t, 2> outputShape = { 1, 1000 };
 
-        // uint_8, [0, 255] -> float, [0 and 1] => Normalize number to between 0 and 1, Convert to vector<float> from cv::Mat.
-        vector<float> vec;
-        image.convertTo(vec, CV_32FC1, 1. / 255);
+        const size_t inputSize = preprocessor.outputSize();
+        const float* imageData = visionInputData(query, inputSize);
+        auto inputTensor = Ort::Value::CreateTensor<float>(memory_info, const_cast<float*>(imageData), inputSize, inputShape.data(), inputShape.size());
+        auto outputTensor = Ort::Value::CreateTensor<float>(memory_info, output, outputShape[1], outputShape.data(), outputShape.size());
 
-        // Mean and Std deviation values
-        const vector<float> means = { 0.485, 0.456, 0.406 };
-        const vector<float> stds = { 0.229, 0.224, 0.225 };
+        // Run inference
+        runSession.Run(runOptions, inputNames.data(), &inputTensor, 1, outputNames.data(), &outputTensor, 1);
+    }
 
-        // Transpose (Height, Width, Channel)(224,224,3) to (Chanel, Height, Width)(3,224,224)
-        vector<float> output;
-        for (size_t ch = 0; ch < 3; ++ch)
-        {
-            for (size_t i = ch; i < vec.size(); i += 3)
-            {
-                float normalized = (vec[i] - means[ch]) / stds[ch];
-                output.emplace_back(normalized);
-            }
+    // Runs query i on some session for every i in [0, count): spread over the replicas in throughput
+    // mode, in order on the single session otherwise.
+    template <typename QueryFn>
+    void forEachQuery(size_t count, QueryFn&& queryFn)
+    {
+        if (sessionPool) {
+            sessionPool->run(count, [&](size_t replica, size_t i) { queryFn(sessionPool->session(replica), i); });
+        }
+        else {
+            for (size_t i = 0; i < count; ++i)
+                queryFn(*session, i);
         }
-        return output;
     }
 
     virtual vector<BMTVisionResult> inferVision(const vector<VariantType>& data) override
     {
-        const int querySize = data.size();
-        vector<BMTVisionResult> results;
-
-        //onnx option setting
-        const array<int64_t, 4> inputShape = { 1, 3, 224, 224 };
-        const array<int64_t, 2> outputShape = { 1, 1000 };
+        vector<BMTVisionResult> results(data.size());
+        vector<char> valid(data.size(), 1);
 
-        for (int i = 0; i < querySize; ++i) {
-            // Prepare input/output tensors
-            vector<float> imageVec;
+        forEachQuery(data.size(), [&](Session& runSession, size_t i) {
+            results[i].classProbabilities.resize(1000);
             try {
-                imageVec = get<vector<float>>(data[i]);
+                runQuery(runSession, data[i], results[i].classProbabilities.data());
             }
             catch (const std::bad_variant_access& e) {
                 cerr << "Error: bad_variant_access at index " << i << ". Reason: " << e.what() << endl;
-                continue;
+                valid[i] = 0;
             }
-            vector<float> outputData(1000);
-            auto inputTensor = Ort::Value::CreateTensor<float>(memory_info, imageVec.data(), imageVec.size(), inputShape.data(), inputShape.size());
-            auto outputTensor = Ort::Value::CreateTensor<float>(memory_info, outputData.data(), outputData.size(), outputShape.data(), outputShape.size());
-
-            // Run inference
-            session->Run(runOptions, inputNames.data(), &inputTensor, 1, outputNames.data(), &outputTensor, 1);
+        });
 
-            // Update results
-            BMTVisionResult result;
-            result.classProbabilities = outputData;
-            results.push_back(result);
+        // Queries that could not be read are left out, as before.
+        size_t kept = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (valid[i])
+                results[kept++] = move(results[i]);
         }
-
+        results.resize(kept);
         return results;
     }
+
+    // Writes query i's 1000 scores into outputs[i]; not an AI_BMT_Interface override (see vision_output_buffer.hpp).
+    // A query that is not a float vector throws, since its buffer would otherwise be left unwritten.
+    void inferVisionInto(const vector<VariantType>& data, const vector<VisionOutputBuffer>& outputs)
+    {
+        if (data.size() != outputs.size()) throw runtime_error("inferVisionInto(..): one output buffer per query is required");
+
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (outputs[i].size != 1000) throw runtime_error("inferVisionInto(..): output buffer " + to_string(i) + " must hold 1000 elements");
+        }
+        forEachQuery(data.size(), [&](Session& runSession, size_t i) {
+            try {
+                runQuery(runSession, data[i], outputs[i].data);
+            }
+            catch (const std::bad_variant_access& e) {
+                throw runtime_error("inferVisionInto(..): bad_variant_access at index " + to_string(i) + ". Reason: " + e.what());
+            }
+        });
+    }
 };
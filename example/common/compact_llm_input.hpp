@@ -0,0 +1,219 @@
+#ifndef _COMPACT_LLM_INPUT_HPP_
+#define _COMPACT_LLM_INPUT_HPP_
+
+#include "ai_bmt_interface.h"
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Compact LLM query carried through VariantType as a vector<int32_t>:
+//
+//   [0] COMPACT_LLM_MAGIC   [1] N   [2] S   [3] flags
+//   N * S token ids (int32)
+//   mask:        N row lengths (rows are 1...1 0...0)     if CompactMaskLengths
+//                ceil(N*S / 32) bit words                  if CompactMaskBits
+//   token types: ceil(N*S / 32) bit words (values 0 / 1)   if CompactTypeBits
+//                N * S int32 values                        if CompactTypeValues
+//
+// Ids take 4 bytes per token instead of 8 and masks/type ids almost nothing, so a query costs
+// about half of an LLMPreprocessedInput to build, copy and keep alive. It is expanded to int64
+// only when the ORT tensors are bound, into scratch buffers that are reused across queries.
+constexpr int32_t COMPACT_LLM_MAGIC = 0x314D4C4C; // "LLM1"
+
+enum CompactLLMFlags : int32_t
+{
+    CompactMaskLengths = 1 << 0,
+    CompactMaskBits = 1 << 1,
+    CompactTypeBits = 1 << 2,
+    CompactTypeValues = 1 << 3,
+};
+
+constexpr size_t COMPACT_LLM_HEADER_SIZE = 4;
+
+inline size_t compactBitWords(size_t count) { return (count + 31) / 32; }
+
+// Encodes `input`. `withMask` / `withTypes` say whether the model consumes them; a missing or
+// mis-sized mask is treated as all ones and missing type ids as zeros (as the ORT example did).
+// Returns false (and leaves `out` empty) if a token id does not fit in int32.
+inline bool packLLMInput(const LLMPreprocessedInput &input, bool withMask, bool withTypes, std::vector<int32_t> &out)
+{
+    out.clear();
+    const size_t total = input.input_ids.size();
+    const size_t rows = input.N > 0 ? static_cast<size_t>(input.N) : 1;
+    const size_t cols = input.S > 0 ? static_cast<size_t>(input.S) : total;
+    if (rows * cols != total)
+        return false;
+
+    for (int64_t id : input.input_ids)
+    {
+        if (id < std::numeric_limits<int32_t>::min() || id > std::numeric_limits<int32_t>::max())
+            return false;
+    }
+
+    int32_t flags = 0;
+    const bool hasMask = withMask && input.attention_mask.size() == total;
+    const bool hasTypes = withTypes && input.token_type_ids.size() == total;
+
+    // A mask that is a prefix of ones in every row is stored as row lengths.
+    std::vector<int32_t> rowLengths;
+    if (withMask)
+    {
+        bool prefix = true;
+        rowLengths.assign(rows, static_cast<int32_t>(cols));
+        if (hasMask)
+        {
+            for (size_t r = 0; r < rows && prefix; ++r)
+            {
+                const int64_t *row = input.attention_mask.data() + r * cols;
+                size_t length = 0;
+                while (length < cols && row[length] != 0)
+                    ++length;
+                for (size_t c = length; c < cols && prefix; ++c)
+                    prefix = row[c] == 0;
+                rowLengths[r] = static_cast<int32_t>(length);
+            }
+        }
+        flags |= prefix ? CompactMaskLengths : CompactMaskBits;
+    }
+    if (withTypes)
+    {
+        bool binary = true;
+        if (hasTypes)
+        {
+            for (int64_t t : input.token_type_ids)
+                binary = binary && (t == 0 || t == 1);
+        }
+        flags |= binary ? CompactTypeBits : CompactTypeValues;
+    }
+
+    size_t size = COMPACT_LLM_HEADER_SIZE + total;
+    if (flags & CompactMaskLengths) size += rows;
+    if (flags & CompactMaskBits) size += compactBitWords(total);
+    if (flags & CompactTypeBits) size += compactBitWords(total);
+    if (flags & CompactTypeValues) size += total;
+    out.reserve(size);
+
+    out.push_back(COMPACT_LLM_MAGIC);
+    out.push_back(static_cast<int32_t>(rows));
+    out.push_back(static_cast<int32_t>(cols));
+    out.push_back(flags);
+    for (int64_t id : input.input_ids)
+        out.push_back(static_cast<int32_t>(id));
+
+    auto pushBits = [&](const std::vector<int64_t> &values) {
+        const size_t first = out.size();
+        out.resize(first + compactBitWords(total), 0);
+        if (values.size() != total)
+            return; // all zeros
+        for (size_t i = 0; i < total; ++i)
+        {
+            if (values[i] != 0)
+                out[first + i / 32] |= static_cast<int32_t>(1u << (i % 32));
+        }
+    };
+
+    if (flags & CompactMaskLengths)
+        out.insert(out.end(), rowLengths.begin(), rowLengths.end());
+    if (flags & CompactMaskBits)
+        pushBits(input.attention_mask);
+    if (flags & CompactTypeBits)
+        pushBits(input.token_type_ids);
+    if (flags & CompactTypeValues)
+    {
+        for (int64_t t : input.token_type_ids)
+            out.push_back(static_cast<int32_t>(t));
+    }
+    return true;
+}
+
+inline bool isCompactLLMInput(const std::vector<int32_t> &data)
+{
+    return data.size() >= COMPACT_LLM_HEADER_SIZE && data[0] == COMPACT_LLM_MAGIC;
+}
+
+// int64 tensors for one query. Keep one instance per session and reuse it: expandLLMInput only
+// grows the buffers, so steady-state binding does not allocate.
+struct LLMTensorScratch
+{
+    std::vector<int64_t> inputIds;
+    std::vector<int64_t> attentionMask;
+    std::vector<int64_t> tokenTypeIds;
+    int64_t N = 0;
+    int64_t S = 0;
+    bool hasMask = false;
+    bool hasTypes = false;
+};
+
+inline void expandLLMInput(const std::vector<int32_t> &data, LLMTensorScratch &scratch)
+{
+    if (!isCompactLLMInput(data))
+        throw std::invalid_argument("Not a compact LLM input");
+
+    if (data[1] <= 0 || data[2] <= 0)
+        throw std::invalid_argument("Compact LLM input has an invalid shape");
+    const size_t rows = static_cast<size_t>(data[1]);
+    const size_t cols = static_cast<size_t>(data[2]);
+    const int32_t flags = data[3];
+    const int32_t knownFlags = CompactMaskLengths | CompactMaskBits | CompactTypeBits | CompactTypeValues;
+    if ((flags & ~knownFlags) != 0)
+        throw std::invalid_argument("Compact LLM input has unknown flags");
+
+    // The header comes from the query data, so the payload it describes is checked against the
+    // buffer before anything is read.
+    if (rows > (std::numeric_limits<size_t>::max() - data.size()) / cols / 3)
+        throw std::invalid_argument("Compact LLM input shape is too large");
+    const size_t total = rows * cols;
+    size_t expected = COMPACT_LLM_HEADER_SIZE + total;
+    if (flags & CompactMaskLengths) expected += rows;
+    if (flags & CompactMaskBits) expected += compactBitWords(total);
+    if (flags & CompactTypeBits) expected += compactBitWords(total);
+    if (flags & CompactTypeValues) expected += total;
+    if (data.size() != expected)
+        throw std::invalid_argument("Compact LLM input holds " + std::to_string(data.size()) + " values, its header describes " + std::to_string(expected));
+    scratch.N = static_cast<int64_t>(rows);
+    scratch.S = static_cast<int64_t>(cols);
+    scratch.hasMask = (flags & (CompactMaskLengths | CompactMaskBits)) != 0;
+    scratch.hasTypes = (flags & (CompactTypeBits | CompactTypeValues)) != 0;
+
+    const int32_t *cursor = data.data() + COMPACT_LLM_HEADER_SIZE;
+    scratch.inputIds.resize(total);
+    for (size_t i = 0; i < total; ++i)
+        scratch.inputIds[i] = cursor[i];
+    cursor += total;
+
+    auto expandBits = [&](std::vector<int64_t> &dst) {
+        dst.resize(total);
+        for (size_t i = 0; i < total; ++i)
+            dst[i] = (static_cast<uint32_t>(cursor[i / 32]) >> (i % 32)) & 1u;
+        cursor += compactBitWords(total);
+    };
+
+    if (flags & CompactMaskLengths)
+    {
+        scratch.attentionMask.resize(total);
+        for (size_t r = 0; r < rows; ++r)
+        {
+            const size_t length = static_cast<size_t>(cursor[r]);
+            int64_t *row = scratch.attentionMask.data() + r * cols;
+            for (size_t c = 0; c < cols; ++c)
+                row[c] = c < length ? 1 : 0;
+        }
+        cursor += rows;
+    }
+    if (flags & CompactMaskBits)
+        expandBits(scratch.attentionMask);
+    if (flags & CompactTypeBits)
+        expandBits(scratch.tokenTypeIds);
+    if (flags & CompactTypeValues)
+    {
+        scratch.tokenTypeIds.resize(total);
+        for (size_t i = 0; i < total; ++i)
+            scratch.tokenTypeIds[i] = cursor[i];
+        cursor += total;
+    }
+}
+
+#endif // _COMPACT_LLM_INPUT_HPP_
@@ -0,0 +1,64 @@
+#ifndef _DATASET_READAHEAD_HPP_
+#define _DATASET_READAHEAD_HPP_
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "../../utils/dataset_reader.hpp"
+
+// Optional read-ahead for the vision examples (utils/dataset_reader.cpp is part of PROJECT_SOURCES).
+// Cold-cache or network-mounted datasets otherwise stall every preprocessVisionData call on imread's
+// synchronous read; with a plan of the access order the files are read on background threads and
+// only decoded on the calling thread.
+//
+//   AI_BMT_READAHEAD_LIST=/path/to/val.txt   list file (labels.txt, val.txt) or image directory
+//   AI_BMT_READAHEAD_DEPTH=16                files kept read ahead in memory
+//   AI_BMT_READAHEAD_THREADS=4               background readers
+//
+// The reader is shared per process and list: every example instance (several interfaces, or the
+// instances behind a sharded submitter) gets the same one, so the files are read once and no extra
+// reader threads are started. It is released with the last instance that uses it.
+inline std::shared_ptr<DatasetReadahead> datasetReadaheadFromEnvironment()
+{
+    const char *list = std::getenv("AI_BMT_READAHEAD_LIST");
+    if (list == nullptr)
+        return nullptr;
+
+    static std::mutex sharedMutex;
+    static std::map<std::string, std::weak_ptr<DatasetReadahead>> shared;
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (auto readahead = shared[list].lock())
+        return readahead;
+
+    std::vector<std::string> plan = plan_dataset_order(list);
+    if (plan.empty())
+        return nullptr;
+
+    ReadaheadConfig config;
+    if (const char *depth = std::getenv("AI_BMT_READAHEAD_DEPTH"))
+        config.depth = static_cast<size_t>(std::max(1, std::atoi(depth)));
+    if (const char *threads = std::getenv("AI_BMT_READAHEAD_THREADS"))
+        config.threads = static_cast<size_t>(std::max(1, std::atoi(threads)));
+    auto readahead = std::make_shared<DatasetReadahead>(std::move(plan), config);
+    shared[list] = readahead;
+    return readahead;
+}
+
+// cv::imread(path), served from the read-ahead buffers when `readahead` is set.
+inline cv::Mat loadImage(DatasetReadahead *readahead, const std::string &path)
+{
+    if (readahead == nullptr)
+        return cv::imread(path);
+
+    FileBytes bytes = readahead->read(path);
+    if (!bytes || bytes->empty())
+        return cv::Mat();
+    const cv::Mat encoded(1, static_cast<int>(bytes->size()), CV_8UC1, const_cast<uint8_t *>(bytes->data()));
+    return cv::imdecode(encoded, cv::IMREAD_COLOR);
+}
+
+#endif // _DATASET_READAHEAD_HPP_
@@ -0,0 +1,139 @@
+#ifndef _LETTERBOX_HPP_
+#define _LETTERBOX_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+
+// Geometry of one letterboxed image: the source is scaled by `scale` (aspect preserved),
+// placed at (pad_left, pad_top) and the rest of the model input is padding.
+struct LetterboxInfo
+{
+    float scale = 1.0f;
+    int pad_left = 0;
+    int pad_top = 0;
+    int resized_width = 0;
+    int resized_height = 0;
+
+    // Maps a point from model-input pixels back to source-image pixels.
+    void toSource(float &x, float &y) const
+    {
+        x = (x - pad_left) / scale;
+        y = (y - pad_top) / scale;
+    }
+};
+
+inline LetterboxInfo computeLetterbox(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    LetterboxInfo info;
+    info.scale = std::min(static_cast<float>(dstWidth) / srcWidth, static_cast<float>(dstHeight) / srcHeight);
+    info.resized_width = std::min(dstWidth, static_cast<int>(std::lround(srcWidth * info.scale)));
+    info.resized_height = std::min(dstHeight, static_cast<int>(std::lround(srcHeight * info.scale)));
+    info.pad_left = (dstWidth - info.resized_width) / 2;
+    info.pad_top = (dstHeight - info.resized_height) / 2;
+    return info;
+}
+
+namespace letterbox_detail
+{
+template <typename OutT>
+inline OutT convertValue(float v)
+{
+    if (std::is_integral<OutT>::value)
+        return static_cast<OutT>(std::min(255.0f, std::max(0.0f, v + 0.5f)));
+    return static_cast<OutT>(v);
+}
+}
+
+// Fused letterbox preprocessing: one pass over the output tensor that resizes (bilinear, aspect
+// preserved), pads, swaps B/R (when swapRB), scales by `valueScale` and writes planar CHW.
+//
+// src: interleaved 3-channel uint8 image (BGR from imread), rows `srcStride` bytes apart.
+// dst: 3 * dstHeight * dstWidth elements of OutT (float or uint8_t).
+// When the source already has the model size this is a straight convert/transposing copy.
+template <typename OutT>
+LetterboxInfo letterboxToCHW(const uint8_t *src, int srcWidth, int srcHeight, size_t srcStride,
+                             int dstWidth, int dstHeight, bool swapRB, float valueScale, OutT padValue, OutT *dst)
+{
+    const LetterboxInfo info = computeLetterbox(srcWidth, srcHeight, dstWidth, dstHeight);
+    const size_t plane = static_cast<size_t>(dstWidth) * dstHeight;
+    OutT *planes[3] = {dst, dst + plane, dst + 2 * plane};
+    const int srcChannel[3] = {swapRB ? 2 : 0, 1, swapRB ? 0 : 2};
+
+    if (srcWidth == dstWidth && srcHeight == dstHeight)
+    {
+        for (int y = 0; y < dstHeight; ++y)
+        {
+            const uint8_t *row = src + y * srcStride;
+            const size_t rowOffset = static_cast<size_t>(y) * dstWidth;
+            for (int c = 0; c < 3; ++c)
+            {
+                OutT *out = planes[c] + rowOffset;
+                const uint8_t *in = row + srcChannel[c];
+                for (int x = 0; x < dstWidth; ++x)
+                    out[x] = letterbox_detail::convertValue<OutT>(in[3 * x] * valueScale);
+            }
+        }
+        return info;
+    }
+
+    // Horizontal taps are the same for every row: compute them once per call.
+    thread_local std::vector<int> x0Offsets, x1Offsets;
+    thread_local std::vector<float> xWeights;
+    x0Offsets.resize(info.resized_width);
+    x1Offsets.resize(info.resized_width);
+    xWeights.resize(info.resized_width);
+    const float invScaleX = static_cast<float>(srcWidth) / info.resized_width;
+    const float invScaleY = static_cast<float>(srcHeight) / info.resized_height;
+    for (int x = 0; x < info.resized_width; ++x)
+    {
+        float fx = std::max(0.0f, (x + 0.5f) * invScaleX - 0.5f);
+        int x0 = std::min(static_cast<int>(fx), srcWidth - 1);
+        int x1 = std::min(x0 + 1, srcWidth - 1);
+        x0Offsets[x] = 3 * x0;
+        x1Offsets[x] = 3 * x1;
+        xWeights[x] = fx - x0;
+    }
+
+    for (int y = 0; y < dstHeight; ++y)
+    {
+        const size_t rowOffset = static_cast<size_t>(y) * dstWidth;
+        const int ry = y - info.pad_top;
+        if (ry < 0 || ry >= info.resized_height)
+        {
+            for (int c = 0; c < 3; ++c)
+                std::fill(planes[c] + rowOffset, planes[c] + rowOffset + dstWidth, padValue);
+            continue;
+        }
+
+        float fy = std::max(0.0f, (ry + 0.5f) * invScaleY - 0.5f);
+        int y0 = std::min(static_cast<int>(fy), srcHeight - 1);
+        int y1 = std::min(y0 + 1, srcHeight - 1);
+        const float wy = fy - y0;
+        const uint8_t *row0 = src + y0 * srcStride;
+        const uint8_t *row1 = src + y1 * srcStride;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            OutT *out = planes[c] + rowOffset;
+            std::fill(out, out + info.pad_left, padValue);
+            std::fill(out + info.pad_left + info.resized_width, out + dstWidth, padValue);
+            out += info.pad_left;
+            const uint8_t *r0 = row0 + srcChannel[c];
+            const uint8_t *r1 = row1 + srcChannel[c];
+            for (int x = 0; x < info.resized_width; ++x)
+            {
+                const float wx = xWeights[x];
+                const float top = r0[x0Offsets[x]] + (r0[x1Offsets[x]] - r0[x0Offsets[x]]) * wx;
+                const float bottom = r1[x0Offsets[x]] + (r1[x1Offsets[x]] - r1[x0Offsets[x]]) * wx;
+                out[x] = letterbox_detail::convertValue<OutT>((top + (bottom - top) * wy) * valueScale);
+            }
+        }
+    }
+    return info;
+}
+
+#endif // _LETTERBOX_HPP_
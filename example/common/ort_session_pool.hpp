@@ -0,0 +1,177 @@
+#ifndef _ORT_SESSION_POOL_HPP_
+#define _ORT_SESSION_POOL_HPP_
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../utils/thread_placement.hpp"
+
+// Throughput mode for the ORT CPU examples. One session whose intra-op pool splits every batch-1
+// inference across all cores scales poorly for small models (ResNet-50) on many-core hosts; N
+// replicas with one or two threads each, fed concurrently, keep every core busy on its own query.
+//
+//   AI_BMT_ORT_REPLICAS=8          number of session replicas (unset or 1: the usual single session)
+//   AI_BMT_ORT_REPLICA_THREADS=1   intra-op threads per replica
+//   AI_BMT_INFERENCE_CPUS=0-7      optional: split across the replicas (pins each replica's worker and intra-op threads)
+struct OrtThroughputConfig
+{
+    size_t replicas = 1;
+    int threadsPerReplica = 1;
+
+    bool enabled() const { return replicas > 1; }
+};
+
+inline OrtThroughputConfig ortThroughputConfigFromEnvironment()
+{
+    OrtThroughputConfig config;
+    if (const char *replicas = std::getenv("AI_BMT_ORT_REPLICAS"))
+        config.replicas = static_cast<size_t>(std::max(1, std::atoi(replicas)));
+    if (const char *threads = std::getenv("AI_BMT_ORT_REPLICA_THREADS"))
+        config.threadsPerReplica = std::max(1, std::atoi(threads));
+    return config;
+}
+
+// N sessions of one model and one worker thread per session. The replicas share a
+// PrepackedWeightsContainer, so weights that ORT prepacks (GEMM/conv kernels) are stored once
+// instead of once per replica. Every run() call queues its indices on one shared work queue, so
+// concurrent callers (several batch-1 inferVision calls, for example) are spread across the free
+// replicas instead of taking turns on the whole pool.
+class OrtSessionPool
+{
+private:
+    // One run() call: its indices are handed out in order, the caller waits for `remaining`.
+    struct Call
+    {
+        const std::function<void(size_t, size_t)> *fn;
+        size_t count;
+        size_t next = 0;
+        size_t remaining;
+        std::exception_ptr error;
+    };
+
+    Ort::PrepackedWeightsContainer prepackedWeights; // must outlive the sessions below
+    std::vector<std::shared_ptr<Ort::Session>> sessions;
+    std::vector<CpuSet> replicaCpus; // from AI_BMT_INFERENCE_CPUS, empty = unpinned
+
+    std::mutex mutex;
+    std::condition_variable condWork;
+    std::condition_variable condDone;
+    std::deque<std::shared_ptr<Call>> calls; // calls with indices not handed out yet
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void workerLoop(size_t replica)
+    {
+        // The worker is intra-op thread 0 of its replica; ort_intra_op_affinities() places the others
+        // from the second core of the replica's set on.
+        if (replica < replicaCpus.size() && !replicaCpus[replica].empty())
+            pin_current_thread(CpuSet{{replicaCpus[replica].cpus.front()}});
+
+        while (true)
+        {
+            std::shared_ptr<Call> call;
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condWork.wait(lock, [&] { return stopping || !calls.empty(); });
+                if (stopping)
+                    return;
+                call = calls.front();
+                index = call->next++;
+                if (call->next == call->count)
+                    calls.pop_front();
+            }
+            try
+            {
+                (*call->fn)(replica, index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!call->error)
+                    call->error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--call->remaining == 0)
+                condDone.notify_all();
+        }
+    }
+
+public:
+    // `configure` applies the example's usual session options; thread counts are set by the pool.
+    OrtSessionPool(Ort::Env &env, const std::wstring &modelPath, const OrtThroughputConfig &config,
+                   const std::function<void(Ort::SessionOptions &)> &configure)
+    {
+        const size_t replicas = std::max<size_t>(1, config.replicas);
+        if (const char *cpuList = std::getenv("AI_BMT_INFERENCE_CPUS"))
+            replicaCpus = CpuSet::parse(cpuList).split(replicas);
+
+        for (size_t r = 0; r < replicas; ++r)
+        {
+            Ort::SessionOptions sessionOptions;
+            configure(sessionOptions);
+            sessionOptions.SetIntraOpNumThreads(config.threadsPerReplica);
+            sessionOptions.SetInterOpNumThreads(1);
+            // Spinning intra-op threads of idle replicas would steal cores from the busy ones.
+            sessionOptions.AddConfigEntry("session.intra_op.allow_spinning", "0");
+            if (r < replicaCpus.size() && !replicaCpus[r].empty())
+            {
+                const std::string affinities = ort_intra_op_affinities(replicaCpus[r], config.threadsPerReplica);
+                if (!affinities.empty())
+                    sessionOptions.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+            }
+            sessions.push_back(std::make_shared<Ort::Session>(env, modelPath.c_str(), sessionOptions, prepackedWeights));
+        }
+        for (size_t r = 0; r < replicas; ++r)
+            workers.emplace_back(&OrtSessionPool::workerLoop, this, r);
+    }
+
+    ~OrtSessionPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condWork.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    OrtSessionPool(const OrtSessionPool &) = delete;
+    OrtSessionPool &operator=(const OrtSessionPool &) = delete;
+
+    size_t size() const { return sessions.size(); }
+    Ort::Session &session(size_t replica) { return *sessions[replica]; }
+
+    // Calls fn(replica, index) for every index in [0, count), each replica running one query at a
+    // time on its own worker. Concurrent calls share the replicas. Returns when all of this call's
+    // indices are done; its first exception is rethrown.
+    void run(size_t count, const std::function<void(size_t, size_t)> &fn)
+    {
+        if (count == 0)
+            return;
+        auto call = std::make_shared<Call>();
+        call->fn = &fn;
+        call->count = count;
+        call->remaining = count;
+        std::unique_lock<std::mutex> lock(mutex);
+        calls.push_back(call);
+        // Wake only as many workers as there are indices; busy ones pick up the queue when they finish.
+        for (size_t i = 0; i < std::min(count, workers.size()); ++i)
+            condWork.notify_one();
+        condDone.wait(lock, [&] { return call->remaining == 0; });
+        if (call->error)
+            std::rethrow_exception(call->error);
+    }
+};
+
+#endif // _ORT_SESSION_POOL_HPP_
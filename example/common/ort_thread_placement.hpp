@@ -0,0 +1,28 @@
+#ifndef _ORT_THREAD_PLACEMENT_HPP_
+#define _ORT_THREAD_PLACEMENT_HPP_
+
+#include <onnxruntime_cxx_api.h>
+#include <cstdlib>
+#include <string>
+#include "../../utils/thread_placement.hpp"
+
+// Pins ONNX Runtime's intra-op thread pool to the cores listed in AI_BMT_INFERENCE_CPUS
+// (cpulist format, e.g. "0-7" for the first socket). One intra-op thread is used per listed core.
+// Without the variable ORT keeps its default, unpinned pool.
+inline void applyOrtThreadPlacement(Ort::SessionOptions &sessionOptions)
+{
+    const char *cpuList = std::getenv("AI_BMT_INFERENCE_CPUS");
+    if (cpuList == nullptr)
+        return;
+
+    const CpuSet cpus = CpuSet::parse(cpuList);
+    if (cpus.empty())
+        return;
+
+    sessionOptions.SetIntraOpNumThreads(static_cast<int>(cpus.size()));
+    const std::string affinities = ort_intra_op_affinities(cpus, cpus.size());
+    if (!affinities.empty())
+        sessionOptions.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+}
+
+#endif // _ORT_THREAD_PLACEMENT_HPP_
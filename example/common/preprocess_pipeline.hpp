@@ -0,0 +1,148 @@
+#ifndef _PREPROCESS_PIPELINE_HPP_
+#define _PREPROCESS_PIPELINE_HPP_
+
+#include "ai_bmt_interface.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+// Compile-time specialized vision preprocessing: input size, channel order, normalization constants
+// and output layout are template parameters, so each model gets a branch-free, division-free loop
+// with constant trip counts that the compiler can fully unroll and vectorize.
+//
+// Source images are interleaved 8-bit BGR (as returned by cv::imread) of exactly Width x Height.
+
+enum class ChannelOrder
+{
+    RGB, // swap B and R while normalizing
+    BGR, // keep the source order
+};
+
+enum class TensorLayout
+{
+    CHW,
+    HWC,
+};
+
+// Normalization constants, in output channel order: out = (in / 255 - mean) / std.
+struct ImageNetNormalization
+{
+    static constexpr float mean[3] = {0.485f, 0.456f, 0.406f};
+    static constexpr float std[3] = {0.229f, 0.224f, 0.225f};
+};
+
+struct HalfNormalization // e.g. DeepLabV3-MobileNetV2 exports
+{
+    static constexpr float mean[3] = {0.5f, 0.5f, 0.5f};
+    static constexpr float std[3] = {0.5f, 0.5f, 0.5f};
+};
+
+template <int Width, int Height, ChannelOrder Order, typename Norm, TensorLayout Layout>
+struct VisionPreprocessor
+{
+    static constexpr int width = Width;
+    static constexpr int height = Height;
+    static constexpr size_t outputSize = static_cast<size_t>(3) * Width * Height;
+
+    // Folded into one multiply-add per value: out = in * scale[c] + bias[c] (c = output channel).
+    static constexpr int srcChannel(int c) { return Order == ChannelOrder::RGB ? 2 - c : c; }
+    static constexpr float scale(int c) { return 1.0f / (255.0f * Norm::std[c]); }
+    static constexpr float bias(int c) { return -Norm::mean[c] / Norm::std[c]; }
+
+    static void run(const uint8_t *src, size_t srcStride, float *dst)
+    {
+        constexpr float s0 = scale(0), s1 = scale(1), s2 = scale(2);
+        constexpr float b0 = bias(0), b1 = bias(1), b2 = bias(2);
+        constexpr int c0 = srcChannel(0), c1 = srcChannel(1), c2 = srcChannel(2);
+        constexpr size_t plane = static_cast<size_t>(Width) * Height;
+
+        for (int y = 0; y < Height; ++y)
+        {
+            const uint8_t *row = src + y * srcStride;
+            if (Layout == TensorLayout::CHW)
+            {
+                float *out0 = dst + static_cast<size_t>(y) * Width;
+                float *out1 = out0 + plane;
+                float *out2 = out1 + plane;
+                for (int x = 0; x < Width; ++x)
+                {
+                    out0[x] = row[3 * x + c0] * s0 + b0;
+                    out1[x] = row[3 * x + c1] * s1 + b1;
+                    out2[x] = row[3 * x + c2] * s2 + b2;
+                }
+            }
+            else
+            {
+                float *out = dst + static_cast<size_t>(y) * Width * 3;
+                for (int x = 0; x < Width; ++x)
+                {
+                    out[3 * x + 0] = row[3 * x + c0] * s0 + b0;
+                    out[3 * x + 1] = row[3 * x + c1] * s1 + b1;
+                    out[3 * x + 2] = row[3 * x + c2] * s2 + b2;
+                }
+            }
+        }
+    }
+};
+
+// Instantiations used by the examples.
+using ClassificationPreprocessor = VisionPreprocessor<224, 224, ChannelOrder::RGB, ImageNetNormalization, TensorLayout::CHW>;
+using SegmentationPreprocessor = VisionPreprocessor<520, 520, ChannelOrder::RGB, ImageNetNormalization, TensorLayout::CHW>;
+using SegmentationMobileNetV2Preprocessor = VisionPreprocessor<520, 520, ChannelOrder::RGB, HalfNormalization, TensorLayout::CHW>;
+
+// Registry entry: the selected instantiation and the input size it expects.
+struct PreprocessEntry
+{
+    using Function = void (*)(const uint8_t *src, size_t srcStride, float *dst);
+
+    Function run = nullptr;
+    int width = 0;
+    int height = 0;
+
+    size_t outputSize() const { return static_cast<size_t>(3) * width * height; }
+};
+
+template <typename Preprocessor>
+PreprocessEntry makePreprocessEntry()
+{
+    return PreprocessEntry{&Preprocessor::run, Preprocessor::width, Preprocessor::height};
+}
+
+// Maps a task (and model variant, detected from the model path) to its instantiation.
+// Resolve once in initialize(); the per-image path is then a single indirect call.
+inline PreprocessEntry selectPreprocessor(InterfaceType type, const std::string &modelPath)
+{
+    switch (type)
+    {
+    case InterfaceType::ImageClassification:
+    case InterfaceType::ImageClassification_CustomDataset:
+        return makePreprocessEntry<ClassificationPreprocessor>();
+    case InterfaceType::SemanticSegmentation:
+    case InterfaceType::SemanticSegmentation_CustomDataset:
+    {
+        const bool isDeeplabMobileNetv2 = (modelPath.find("v2") != std::string::npos) || (modelPath.find("V2") != std::string::npos);
+        return isDeeplabMobileNetv2 ? makePreprocessEntry<SegmentationMobileNetV2Preprocessor>()
+                                    : makePreprocessEntry<SegmentationPreprocessor>();
+    }
+    default:
+        throw std::invalid_argument("No compile-time preprocessing pipeline registered for this interface type");
+    }
+}
+
+// Input of a preprocessed vision query: the vector<float> returned by preprocessVisionData(..), or a
+// float* into one, as Sharded_Submitter_Implementation passes with ShardInput::View.
+// Throws bad_variant_access for any other alternative.
+inline const float *visionInputData(const VariantType &query, size_t expectedSize)
+{
+    if (const auto *view = std::get_if<float *>(&query))
+        return *view;
+    const std::vector<float> &input = std::get<std::vector<float>>(query);
+    if (input.size() != expectedSize)
+        throw std::runtime_error("Unexpected input size " + std::to_string(input.size()) + ", expected " + std::to_string(expectedSize));
+    return input.data();
+}
+
+#endif // _PREPROCESS_PIPELINE_HPP_
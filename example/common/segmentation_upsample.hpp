@@ -0,0 +1,183 @@
+#ifndef _SEGMENTATION_UPSAMPLE_HPP_
+#define _SEGMENTATION_UPSAMPLE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Post-processing for segmentation models that emit logits below the input resolution (1/4 or 1/8,
+// e.g. 21 x 65 x 65 for a 520 x 520 input). Bilinear upsampling is fused with the per-pixel argmax:
+// each low-resolution row is widened once, and every output row is blended from the two widened rows
+// around it and reduced to class indices right away, so the C x H x W float tensor of upsampled
+// logits never exists. The per-row loops have no branches and unit-stride accesses, which the
+// compiler vectorizes.
+//
+// Sampling matches torch.nn.functional.interpolate(mode="bilinear", align_corners=False).
+
+// Source taps of one axis: output i reads i0[i] and i1[i], weighted (1 - w1[i]) and w1[i].
+struct BilinearTaps
+{
+    std::vector<int> i0;
+    std::vector<int> i1;
+    std::vector<float> w1;
+};
+
+inline BilinearTaps bilinearTaps(int inSize, int outSize)
+{
+    BilinearTaps taps;
+    taps.i0.resize(outSize);
+    taps.i1.resize(outSize);
+    taps.w1.resize(outSize);
+    const float scale = static_cast<float>(inSize) / outSize;
+    for (int i = 0; i < outSize; ++i)
+    {
+        const float src = std::max(0.0f, (i + 0.5f) * scale - 0.5f);
+        const int i0 = std::min(static_cast<int>(src), inSize - 1);
+        taps.i0[i] = i0;
+        taps.i1[i] = std::min(i0 + 1, inSize - 1);
+        taps.w1[i] = src - i0;
+    }
+    return taps;
+}
+
+// Per-call state: the two low-resolution rows around the current output row (upsampled
+// horizontally, for every class) and the running argmax of that output row. Sized on first use and
+// reused afterwards; one per thread.
+struct UpsampleScratch
+{
+    std::vector<float> upper, lower; // classes x outWidth, low-resolution rows upperRow and lowerRow
+    int upperRow = -1, lowerRow = -1;
+    std::vector<float> best;         // running maximum of the current output row
+    std::vector<int32_t> label;      // its class
+};
+
+// Per-model state: the taps of both axes. It is not modified after construction, so one instance
+// serves concurrent calls as long as each passes its own UpsampleScratch.
+class UpsampleArgmax
+{
+private:
+    int classes = 0, inHeight = 0, inWidth = 0, outHeight = 0, outWidth = 0;
+    BilinearTaps rows, cols;
+
+    void prepare(UpsampleScratch &scratch) const
+    {
+        const size_t rowSize = static_cast<size_t>(classes) * outWidth;
+        scratch.upper.resize(rowSize);
+        scratch.lower.resize(rowSize);
+        scratch.best.resize(outWidth);
+        scratch.label.resize(outWidth);
+        scratch.upperRow = scratch.lowerRow = -1;
+    }
+
+    // Horizontal pass of low-resolution row `row` for every class; each row is done once per image.
+    void widenRow(const float *logits, int row, float *dst) const
+    {
+        const size_t plane = static_cast<size_t>(inHeight) * inWidth;
+        const int *x0 = cols.i0.data();
+        const int *x1 = cols.i1.data();
+        const float *wx = cols.w1.data();
+        const int width = outWidth;
+        for (int c = 0; c < classes; ++c)
+        {
+            const float *src = logits + c * plane + static_cast<size_t>(row) * inWidth;
+            float *out = dst + static_cast<size_t>(c) * outWidth;
+            for (int x = 0; x < width; ++x)
+                out[x] = src[x0[x]] + wx[x] * (src[x1[x]] - src[x0[x]]);
+        }
+    }
+
+    // Argmax over classes of output row y, left in `scratch.label`.
+    void argmaxRow(const float *logits, int y, UpsampleScratch &scratch) const
+    {
+        std::vector<float> &upper = scratch.upper, &lower = scratch.lower;
+        int &upperRow = scratch.upperRow, &lowerRow = scratch.lowerRow;
+        const int top = rows.i0[y], bottom = rows.i1[y];
+        if (top != upperRow)
+        {
+            if (top == lowerRow)
+            {
+                std::swap(upper, lower);
+                std::swap(upperRow, lowerRow);
+            }
+            else
+            {
+                widenRow(logits, top, upper.data());
+                upperRow = top;
+            }
+        }
+        if (bottom != lowerRow)
+        {
+            widenRow(logits, bottom, lower.data());
+            lowerRow = bottom;
+        }
+
+        const int width = outWidth; // a local, so the int32 label stores cannot alias the trip count
+        const float wy = rows.w1[y];
+        float *bestRow = scratch.best.data();
+        int32_t *labelRow = scratch.label.data();
+        for (int c = 0; c < classes; ++c)
+        {
+            const float *t = upper.data() + static_cast<size_t>(c) * outWidth;
+            const float *b = lower.data() + static_cast<size_t>(c) * outWidth;
+            if (c == 0)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    bestRow[x] = t[x] + wy * (b[x] - t[x]);
+                    labelRow[x] = 0;
+                }
+                continue;
+            }
+            for (int x = 0; x < width; ++x)
+            {
+                // Mask arithmetic instead of a branch so the loop vectorizes; ties keep the lower
+                // class, like argmax.
+                const float v = t[x] + wy * (b[x] - t[x]);
+                const int32_t greater = -static_cast<int32_t>(v > bestRow[x]);
+                bestRow[x] = std::max(bestRow[x], v);
+                labelRow[x] = (labelRow[x] & ~greater) | (c & greater);
+            }
+        }
+    }
+
+public:
+    UpsampleArgmax(int classes, int inHeight, int inWidth, int outHeight, int outWidth)
+        : classes(classes), inHeight(inHeight), inWidth(inWidth), outHeight(outHeight), outWidth(outWidth),
+          rows(bilinearTaps(inHeight, outHeight)), cols(bilinearTaps(inWidth, outWidth))
+    {
+    }
+
+    // logits: classes x inHeight x inWidth (CHW). labels: outHeight x outWidth class indices.
+    void toLabels(const float *logits, int32_t *labels, UpsampleScratch &scratch) const
+    {
+        prepare(scratch);
+        for (int y = 0; y < outHeight; ++y)
+        {
+            argmaxRow(logits, y, scratch);
+            std::copy(scratch.label.begin(), scratch.label.end(), labels + static_cast<size_t>(y) * outWidth);
+        }
+    }
+
+    // Writes classes x outHeight x outWidth one-hot scores (1 for the winning class, 0 elsewhere) for
+    // consumers that take full-resolution scores and argmax them, such as the BMT segmentation result.
+    void toOneHotScores(const float *logits, float *scores, UpsampleScratch &scratch) const
+    {
+        const size_t plane = static_cast<size_t>(outHeight) * outWidth;
+        const int width = outWidth;
+        prepare(scratch);
+        for (int y = 0; y < outHeight; ++y)
+        {
+            argmaxRow(logits, y, scratch);
+            const int32_t *labelRow = scratch.label.data();
+            for (int c = 0; c < classes; ++c)
+            {
+                float *out = scores + c * plane + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x)
+                    out[x] = labelRow[x] == c ? 1.0f : 0.0f;
+            }
+        }
+    }
+};
+
+#endif // _SEGMENTATION_UPSAMPLE_HPP_
@@ -0,0 +1,149 @@
+#ifndef _SEQUENCE_PACKING_HPP_
+#define _SEQUENCE_PACKING_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Sequence packing for encoder models (BERT GLUE): the real tokens of several short queries are
+// concatenated into one fixed-length row instead of each query running with its own padding.
+//
+// Each segment restarts its position ids at 0 and attends only to itself through a block-diagonal
+// [rowLength x rowLength] mask, so every segment sees exactly what it would see alone. The model
+// must accept position_ids and a 3D attention mask and return per-token outputs; the caller then
+// reads each query's classifier output at its segment's first ([CLS]) token. The LLM example
+// packs only when AI_BMT_PACK_SEQUENCES=1, since packed results hold those logits alone.
+
+struct PackedSegment
+{
+    size_t query;   // index of the query in the batch
+    size_t offset;  // first token of the segment in the row
+    size_t length;  // real tokens of the query
+};
+
+struct PackedRow
+{
+    std::vector<int64_t> inputIds;       // rowLength
+    std::vector<int64_t> tokenTypeIds;   // rowLength
+    std::vector<int64_t> positionIds;    // rowLength
+    std::vector<int64_t> attentionMask;  // rowLength * rowLength, row-major [query token][key token]
+    std::vector<PackedSegment> segments;
+    size_t used = 0;
+};
+
+// Number of real tokens in a padded mask row (the mask is 1...1 0...0).
+inline size_t validTokenCount(const int64_t *mask, size_t length)
+{
+    size_t count = 0;
+    while (count < length && mask[count] != 0)
+        ++count;
+    return count;
+}
+
+// True when the mask is a right-padded prefix (1...1 0...0 with at least one real token), the only
+// layout whose padding can be cut off or packed away. Left padding or holes return false.
+inline bool isPrefixMask(const int64_t *mask, size_t length)
+{
+    const size_t count = validTokenCount(mask, length);
+    if (count == 0)
+        return false;
+    for (size_t t = count; t < length; ++t)
+    {
+        if (mask[t] != 0)
+            return false;
+    }
+    return true;
+}
+
+class SequencePacker
+{
+private:
+    size_t rowLength;
+    size_t rowCount = 0;
+    std::vector<PackedRow> rowPool; // kept across batches so steady-state packing does not allocate
+
+    PackedRow &newRow()
+    {
+        if (rowPool.size() == rowCount)
+            rowPool.emplace_back();
+        PackedRow &row = rowPool[rowCount++];
+        row.inputIds.assign(rowLength, 0);
+        row.tokenTypeIds.assign(rowLength, 0);
+        row.positionIds.assign(rowLength, 0);
+        row.attentionMask.assign(rowLength * rowLength, 0);
+        // Padding tokens attend to themselves only, so no mask row is empty (avoids NaN softmax).
+        for (size_t i = 0; i < rowLength; ++i)
+            row.attentionMask[i * rowLength + i] = 1;
+        row.segments.clear();
+        row.used = 0;
+        return row;
+    }
+
+public:
+    explicit SequencePacker(size_t rowLength = 0) : rowLength(rowLength) {}
+
+    size_t getRowLength() const { return rowLength; }
+
+    // Starts a new batch; rows from the previous batch are recycled.
+    void reset(size_t newRowLength)
+    {
+        rowLength = newRowLength;
+        rowCount = 0;
+    }
+
+    // Adds one query (its real tokens only) to the first row with room (first-fit).
+    // `typeIds` may be null (all zeros).
+    void add(size_t query, const int64_t *ids, const int64_t *typeIds, size_t length)
+    {
+        if (length == 0 || length > rowLength)
+            throw std::invalid_argument("Sequence does not fit in a packed row");
+
+        size_t r = 0;
+        while (r < rowCount && rowPool[r].used + length > rowLength)
+            ++r;
+        if (r == rowCount)
+            newRow();
+
+        PackedRow &row = rowPool[r];
+        const size_t offset = row.used;
+        for (size_t i = 0; i < length; ++i)
+        {
+            row.inputIds[offset + i] = ids[i];
+            row.tokenTypeIds[offset + i] = typeIds ? typeIds[i] : 0;
+            row.positionIds[offset + i] = static_cast<int64_t>(i);
+            int64_t *maskRow = row.attentionMask.data() + (offset + i) * rowLength;
+            for (size_t j = 0; j < length; ++j)
+                maskRow[offset + j] = 1;
+        }
+        row.segments.push_back({query, offset, length});
+        row.used += length;
+    }
+
+    // Adds a query whose mask is not a right-padded prefix (left padding, holes) as a row of its own,
+    // padding included: every token attends to the keys `mask` allows, exactly as when the query
+    // runs unpacked. Its segment starts at the sequence's first token.
+    void addAlone(size_t query, const int64_t *ids, const int64_t *typeIds, const int64_t *mask, size_t length)
+    {
+        if (length == 0 || length > rowLength)
+            throw std::invalid_argument("Sequence does not fit in a packed row");
+
+        PackedRow &row = newRow();
+        for (size_t i = 0; i < length; ++i)
+        {
+            row.inputIds[i] = ids[i];
+            row.tokenTypeIds[i] = typeIds ? typeIds[i] : 0;
+            row.positionIds[i] = static_cast<int64_t>(i);
+            int64_t *maskRow = row.attentionMask.data() + i * rowLength;
+            for (size_t j = 0; j < length; ++j)
+                maskRow[j] = (mask[j] != 0 || j == i) ? 1 : 0;
+        }
+        row.segments.push_back({query, 0, length});
+        row.used = rowLength; // nothing else goes into this row
+    }
+
+    size_t size() const { return rowCount; }
+    const PackedRow &row(size_t r) const { return rowPool[r]; }
+};
+
+#endif // _SEQUENCE_PACKING_HPP_
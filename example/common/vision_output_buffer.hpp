@@ -0,0 +1,52 @@
+#ifndef _VISION_OUTPUT_BUFFER_HPP_
+#define _VISION_OUTPUT_BUFFER_HPP_
+
+#include "ai_bmt_interface.h"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Caller-owned output memory for one vision query. `size` must match the task's output
+// (1,000 for classification, 21 x 520 x 520 for segmentation, the model's YOLO output for detection).
+//
+// Writing into caller memory is an example-side extension for in-process harnesses, not part of
+// AI_BMT_Interface: the BMT app only calls inferVision(..), and adding a virtual would change the
+// vtable the prebuilt BMT library was compiled against. The vision examples provide a member
+// inferVisionInto(..) that binds the model output to these buffers; any other submitter goes
+// through the copying fallback below.
+struct VisionOutputBuffer
+{
+    float *data = nullptr;
+    size_t size = 0;
+};
+
+// The populated output of a vision result, whichever task produced it.
+inline const std::vector<float> &visionResultData(const BMTVisionResult &result)
+{
+    if (!result.classProbabilities.empty())
+        return result.classProbabilities;
+    if (!result.objectDetectionResult.empty())
+        return result.objectDetectionResult;
+    return result.segmentationResult;
+}
+
+// Runs submitter.inferVision(data) and copies result i into outputs[i].
+inline void inferVisionInto(AI_BMT_Interface &submitter, const std::vector<VariantType> &data, const std::vector<VisionOutputBuffer> &outputs)
+{
+    if (data.size() != outputs.size())
+        throw std::runtime_error("inferVisionInto(..): one output buffer per query is required");
+    const std::vector<BMTVisionResult> results = submitter.inferVision(data);
+    if (results.size() != outputs.size())
+        throw std::runtime_error("inferVisionInto(..): inferVision(..) returned " + std::to_string(results.size()) + " results for " + std::to_string(outputs.size()) + " queries");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const std::vector<float> &result = visionResultData(results[i]);
+        if (result.size() != outputs[i].size)
+            throw std::runtime_error("inferVisionInto(..): output buffer " + std::to_string(i) + " holds " + std::to_string(outputs[i].size) + " elements, result has " + std::to_string(result.size()));
+        std::copy(result.begin(), result.end(), outputs[i].data);
+    }
+}
+
+#endif // _VISION_OUTPUT_BUFFER_HPP_
@@ -0,0 +1,223 @@
+#ifndef _YOLO_DECODER_HPP_
+#define _YOLO_DECODER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Output layouts of the YOLO families the BMT accepts, told apart by the output tensor's shape:
+//   AnchorMajor   (1, 25200, 85)  YOLOv5: per anchor cx, cy, w, h, objectness, 80 class scores
+//   ChannelMajor  (1, 84, 8400)   YOLOv5u/v8/v9/11/12: per channel all anchors; cx, cy, w, h, 80 class scores
+//   EndToEnd      (1, 300, 6)     YOLOv10: x1, y1, x2, y2, score, class, already NMS-free
+enum class YoloLayout
+{
+    AnchorMajor,
+    ChannelMajor,
+    EndToEnd,
+};
+
+struct YoloOutputLayout
+{
+    YoloLayout layout = YoloLayout::AnchorMajor;
+    std::vector<int64_t> shape; // (1, dim1, dim2), as declared by the model
+    size_t anchors = 0;
+    size_t classes = 0;
+
+    size_t elements() const { return static_cast<size_t>(shape[1] * shape[2]); }
+};
+
+inline const char *yoloLayoutName(YoloLayout layout)
+{
+    switch (layout)
+    {
+    case YoloLayout::AnchorMajor: return "AnchorMajor";
+    case YoloLayout::ChannelMajor: return "ChannelMajor";
+    case YoloLayout::EndToEnd: return "EndToEnd";
+    }
+    return "Unknown";
+}
+
+// Classifies a (1, A, B) output shape. Box rows are short (6 or 5 + classes values) and anchor
+// counts are large, so the smaller dimension is the per-box one. End-to-end heads emit a few hundred
+// boxes of 6 values, which keeps them apart from a one-class YOLOv5 (25200 x 6). A dynamic batch
+// (-1) is read as 1.
+inline YoloOutputLayout detectYoloLayout(const std::vector<int64_t> &shape)
+{
+    if (shape.size() != 3 || shape[1] <= 0 || shape[2] <= 0)
+    {
+        std::string dims;
+        for (int64_t d : shape)
+            dims += (dims.empty() ? "" : ", ") + std::to_string(d);
+        throw std::runtime_error("Unsupported YOLO output shape (" + dims + "): expected (1, anchors, values) or (1, channels, anchors)");
+    }
+
+    YoloOutputLayout out;
+    out.shape = {1, shape[1], shape[2]};
+    if (shape[2] == 6 && shape[1] > 6 && shape[1] <= 1000)
+    {
+        out.layout = YoloLayout::EndToEnd;
+        out.anchors = static_cast<size_t>(shape[1]);
+    }
+    else if (shape[1] < shape[2])
+    {
+        out.layout = YoloLayout::ChannelMajor;
+        out.anchors = static_cast<size_t>(shape[2]);
+        out.classes = static_cast<size_t>(shape[1] - 4);
+    }
+    else
+    {
+        out.layout = YoloLayout::AnchorMajor;
+        out.anchors = static_cast<size_t>(shape[1]);
+        out.classes = static_cast<size_t>(shape[2] - 5);
+    }
+    return out;
+}
+
+// One box in model-input pixels (corner form) before or after NMS.
+struct YoloDetection
+{
+    float x1, y1, x2, y2;
+    float score;
+    int classId;
+};
+
+// Decodes raw outputs of any YoloLayout in place: channel-major outputs are read one class channel
+// at a time with unit stride across all anchors (a running per-anchor max, vectorized by the
+// compiler), so the (channels x anchors) tensor is never transposed. Scratch buffers are kept
+// between calls; one decoder per thread.
+class YoloDecoder
+{
+private:
+    YoloOutputLayout layout;
+    std::vector<float> bestScore; // ChannelMajor: per-anchor running max
+    std::vector<int32_t> bestClass;
+    std::vector<size_t> order;
+
+    static float iou(const YoloDetection &a, const YoloDetection &b)
+    {
+        const float w = std::min(a.x2, b.x2) - std::max(a.x1, b.x1);
+        const float h = std::min(a.y2, b.y2) - std::max(a.y1, b.y1);
+        if (w <= 0 || h <= 0)
+            return 0;
+        const float inter = w * h;
+        return inter / ((a.x2 - a.x1) * (a.y2 - a.y1) + (b.x2 - b.x1) * (b.y2 - b.y1) - inter);
+    }
+
+    void decodeChannelMajor(const float *output, float confThreshold, std::vector<YoloDetection> &out)
+    {
+        const size_t anchors = layout.anchors;
+        const float *scores = output + 4 * anchors;
+        float *best = bestScore.data();
+        int32_t *label = bestClass.data();
+        std::copy(scores, scores + anchors, best);
+        std::fill(label, label + anchors, 0);
+        for (size_t c = 1; c < layout.classes; ++c)
+        {
+            const float *channel = scores + c * anchors;
+            const int32_t cls = static_cast<int32_t>(c);
+            for (size_t a = 0; a < anchors; ++a)
+            {
+                const int32_t greater = -static_cast<int32_t>(channel[a] > best[a]);
+                best[a] = std::max(best[a], channel[a]);
+                label[a] = (label[a] & ~greater) | (cls & greater);
+            }
+        }
+
+        const float *cx = output, *cy = output + anchors, *w = output + 2 * anchors, *h = output + 3 * anchors;
+        for (size_t a = 0; a < anchors; ++a)
+        {
+            if (best[a] < confThreshold)
+                continue;
+            out.push_back({cx[a] - w[a] / 2, cy[a] - h[a] / 2, cx[a] + w[a] / 2, cy[a] + h[a] / 2, best[a], label[a]});
+        }
+    }
+
+    void decodeAnchorMajor(const float *output, float confThreshold, std::vector<YoloDetection> &out) const
+    {
+        const size_t values = layout.classes + 5;
+        for (size_t a = 0; a < layout.anchors; ++a)
+        {
+            const float *row = output + a * values;
+            const float objectness = row[4];
+            if (objectness < confThreshold) // score = objectness * class score <= objectness
+                continue;
+            const float *classScores = row + 5;
+            const size_t cls = static_cast<size_t>(std::max_element(classScores, classScores + layout.classes) - classScores);
+            const float score = objectness * classScores[cls];
+            if (score < confThreshold)
+                continue;
+            out.push_back({row[0] - row[2] / 2, row[1] - row[3] / 2, row[0] + row[2] / 2, row[1] + row[3] / 2, score, static_cast<int>(cls)});
+        }
+    }
+
+    void decodeEndToEnd(const float *output, float confThreshold, std::vector<YoloDetection> &out) const
+    {
+        for (size_t a = 0; a < layout.anchors; ++a)
+        {
+            const float *row = output + a * 6;
+            if (row[4] >= confThreshold)
+                out.push_back({row[0], row[1], row[2], row[3], row[4], static_cast<int>(row[5])});
+        }
+    }
+
+public:
+    YoloDecoder() = default;
+
+    explicit YoloDecoder(const YoloOutputLayout &layout) : layout(layout)
+    {
+        if (layout.layout == YoloLayout::ChannelMajor)
+        {
+            bestScore.resize(layout.anchors);
+            bestClass.resize(layout.anchors);
+        }
+    }
+
+    const YoloOutputLayout &outputLayout() const { return layout; }
+
+    // Boxes scoring at least confThreshold, in model-input pixels. `out` is cleared first.
+    void decode(const float *output, float confThreshold, std::vector<YoloDetection> &out)
+    {
+        out.clear();
+        switch (layout.layout)
+        {
+        case YoloLayout::AnchorMajor: decodeAnchorMajor(output, confThreshold, out); break;
+        case YoloLayout::ChannelMajor: decodeChannelMajor(output, confThreshold, out); break;
+        case YoloLayout::EndToEnd: decodeEndToEnd(output, confThreshold, out); break;
+        }
+    }
+
+    // Greedy per-class NMS in place; EndToEnd outputs need none and are left as they are.
+    void suppress(std::vector<YoloDetection> &detections, float iouThreshold)
+    {
+        if (layout.layout == YoloLayout::EndToEnd)
+            return;
+        order.resize(detections.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return detections[a].score > detections[b].score; });
+
+        std::vector<YoloDetection> kept;
+        kept.reserve(detections.size());
+        for (size_t i : order)
+        {
+            const YoloDetection &candidate = detections[i];
+            bool keep = true;
+            for (const YoloDetection &k : kept)
+            {
+                if (k.classId == candidate.classId && iou(k, candidate) > iouThreshold)
+                {
+                    keep = false;
+                    break;
+                }
+            }
+            if (keep)
+                kept.push_back(candidate);
+        }
+        detections.swap(kept);
+    }
+};
+
+#endif // _YOLO_DECODER_HPP_
@@ -8,6 +8,12 @@
 #include <unordered_map>
 #include <onnxruntime_cxx_api.h>
 #include <filesystem>
+#include <cstdlib>
+#include <mutex>
+#include "../../common/ort_thread_placement.hpp"
+#include "../../common/compact_llm_input.hpp"
+#include "../../common/sequence_packing.hpp"
+#include "../../../utils/continuous_batcher.hpp"
 
 using namespace std;
 using namespace Ort;
@@ -25,8 +31,346 @@ private:
     vector<const char *> outputNames;
     bool modelHasTokenType = false;
     bool modelHasAttnMask = false;
+    bool modelHasPositionIds = false;
+    bool packSequences = false; // BERT GLUE, opt-in: several queries share one row (see sequence_packing.hpp)
+    bool trimPadding = false;   // BERT GLUE classifier exports, opt-in: each query runs at its real length
+    LLMTensorScratch scratch; // int64 tensors expanded from the compact query, reused across queries
+    vector<int64_t> positionIds;
+    SequencePacker packer;
+
+    // Optional continuous batching (utils/continuous_batcher.hpp): queries, including those of
+    // concurrent inferLLM calls, are scheduled into steps of up to `token_budget` tokens and each
+    // step runs as one padded [B, S] batch. Enabled from the environment in initialize():
+    //   AI_BMT_CONTINUOUS_BATCHING=1      schedule single-sequence queries through the batcher
+    //   AI_BMT_BATCH_TOKEN_BUDGET=4096    tokens per step (sum over the running batch)
+    //   AI_BMT_BATCH_MAX_SIZE=64          sequences per step
+    bool useContinuousBatching = false;
+    ContinuousBatcherConfig batchingConfig;
+    using Batcher = ContinuousBatcher<LLMTensorScratch, BMTLLMResult>;
+    unique_ptr<Batcher> batcher;
+    vector<int64_t> stepIds, stepMask, stepTypes, stepPositions; // used by the batcher thread only
+    mutex unbatchedMutex; // queries the batcher cannot take run through inferOne(), which uses shared scratch
+
+    // Tokens a query occupies in a step: its real length for BERT GLUE, otherwise its padded length.
+    size_t stepLength(const LLMTensorScratch &query) const
+    {
+        const size_t S = static_cast<size_t>(query.S);
+        if (trimPadding && query.hasMask && query.attentionMask.size() == S && isPrefixMask(query.attentionMask.data(), S))
+            return validTokenCount(query.attentionMask.data(), S);
+        return S;
+    }
+
+    void runStep(vector<Batcher::Sequence *> &batch)
+    {
+        const int64_t B = static_cast<int64_t>(batch.size());
+        size_t S = 0;
+        for (auto *sequence : batch)
+            S = max(S, sequence->tokens);
+
+        stepIds.assign(B * S, 0);
+        stepMask.assign(B * S, 0);
+        stepTypes.assign(B * S, 0);
+        stepPositions.assign(B * S, 0);
+        for (int64_t b = 0; b < B; ++b)
+        {
+            const LLMTensorScratch &query = batch[b]->request;
+            const size_t length = batch[b]->tokens;
+            for (size_t t = 0; t < length; ++t)
+            {
+                stepIds[b * S + t] = query.inputIds[t];
+                stepMask[b * S + t] = query.hasMask ? query.attentionMask[t] : 1;
+                stepTypes[b * S + t] = query.hasTypes ? query.tokenTypeIds[t] : 0;
+                stepPositions[b * S + t] = static_cast<int64_t>(t);
+            }
+        }
+
+        const array<int64_t, 2> shape{B, static_cast<int64_t>(S)};
+        vector<Ort::Value> feedVals;
+        for (auto nm : inputNames)
+        {
+            string s(nm);
+            if (s == "input_ids")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, stepIds.data(), stepIds.size(), shape.data(), shape.size()));
+            else if (s == "attention_mask")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, stepMask.data(), stepMask.size(), shape.data(), shape.size()));
+            else if (s == "token_type_ids")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, stepTypes.data(), stepTypes.size(), shape.data(), shape.size()));
+            else if (s == "position_ids")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, stepPositions.data(), stepPositions.size(), shape.data(), shape.size()));
+        }
+
+        auto outs = session->Run(runOptions,
+                                 inputNames.data(), feedVals.data(), feedVals.size(),
+                                 outputNames.data(), outputNames.size());
+
+        // [B, labels] (classifier) or [B, S, vocab] (per-token logits): split per query, keeping the
+        // shape the query would have produced on its own.
+        auto info = outs.front().GetTensorTypeAndShapeInfo();
+        const vector<int64_t> outShape = info.GetShape();
+        const float *buf = outs.front().GetTensorData<float>();
+        for (int64_t b = 0; b < B; ++b)
+        {
+            BMTLLMResult &r = batch[b]->result;
+            if (outShape.size() == 2)
+            {
+                const float *row = buf + b * outShape[1];
+                r.rawOutput.assign(row, row + outShape[1]);
+                r.rawOutputShape = {1, outShape[1]};
+            }
+            else if (outShape.size() == 3)
+            {
+                const int64_t length = static_cast<int64_t>(batch[b]->tokens);
+                const float *row = buf + b * outShape[1] * outShape[2];
+                r.rawOutput.assign(row, row + length * outShape[2]);
+                r.rawOutputShape = {1, length, outShape[2]};
+            }
+            else
+            {
+                throw runtime_error("[inferLLM] Unsupported output rank for batched inference");
+            }
+            batch[b]->finished = true;
+        }
+    }
+
+    // Queries of one sequence go through the batcher; others (N > 1, or unsupported variants) run
+    // unbatched, so every result stays at its query's position.
+    vector<BMTLLMResult> inferBatched(const vector<VariantType> &data)
+    {
+        vector<future<BMTLLMResult>> futures(data.size());
+        vector<BMTLLMResult> unbatched(data.size());
+        vector<bool> valid(data.size(), true);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            LLMTensorScratch query;
+            if (const auto *compact = get_if<vector<int32_t>>(&data[i]); compact && isCompactLLMInput(*compact) && (*compact)[1] == 1)
+            {
+                expandLLMInput(*compact, query);
+            }
+            else if (const auto *in = get_if<LLMPreprocessedInput>(&data[i]); in && in->N == 1)
+            {
+                query.inputIds = in->input_ids;
+                query.attentionMask = in->attention_mask;
+                query.tokenTypeIds = in->token_type_ids;
+                query.N = 1;
+                query.S = static_cast<int64_t>(in->input_ids.size());
+                query.hasMask = in->attention_mask.size() == in->input_ids.size();
+                query.hasTypes = in->token_type_ids.size() == in->input_ids.size();
+            }
+            else
+            {
+                lock_guard<mutex> lock(unbatchedMutex);
+                valid[i] = inferOne(data[i], i, unbatched[i]);
+                continue;
+            }
+            const size_t tokens = stepLength(query);
+            futures[i] = batcher->submit(std::move(query), tokens);
+        }
+
+        // Invalid queries are skipped, as in the unbatched path.
+        vector<BMTLLMResult> results;
+        results.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (futures[i].valid())
+                results.push_back(futures[i].get());
+            else if (valid[i])
+                results.push_back(std::move(unbatched[i]));
+        }
+        return results;
+    }
+
+    size_t inputRank(const string &name) const
+    {
+        for (size_t i = 0; i < inputNameStrs.size(); ++i)
+        {
+            if (inputNameStrs[i] == name)
+                return session->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape().size();
+        }
+        return 0;
+    }
+
+    // Runs one query on its own. Returns false (and leaves `result` empty) for an unsupported variant.
+    bool inferOne(const VariantType &query, size_t index, BMTLLMResult &result)
+    {
+        // Read the query in place (no copy out of the variant).
+        const vector<int64_t> *ids = nullptr;
+        const vector<int64_t> *mask = nullptr;
+        const vector<int64_t> *types = nullptr;
+        array<int64_t, 2> shape{};
+        if (const auto *compact = get_if<vector<int32_t>>(&query); compact && isCompactLLMInput(*compact))
+        {
+            expandLLMInput(*compact, scratch);
+            ids = &scratch.inputIds;
+            mask = &scratch.attentionMask;
+            types = &scratch.tokenTypeIds;
+            shape = {scratch.N, scratch.S};
+        }
+        else if (const auto *in = get_if<LLMPreprocessedInput>(&query))
+        {
+            ids = &in->input_ids;
+            mask = &in->attention_mask;
+            types = &in->token_type_ids;
+            shape = {in->N, in->S};
+        }
+        else
+        {
+            cerr << "[inferLLM] Invalid VariantType at index " << index << endl;
+            return false;
+        }
+
+        // Only a right-padded mask can be cut; anything else runs at full length.
+        size_t count = ids->size();
+        if (trimPadding && shape[0] == 1 && mask->size() == count && isPrefixMask(mask->data(), count))
+        {
+            shape[1] = static_cast<int64_t>(validTokenCount(mask->data(), count));
+            count = static_cast<size_t>(shape[1]);
+        }
+        if (modelHasPositionIds)
+        {
+            positionIds.resize(count);
+            for (size_t t = 0; t < count; ++t)
+                positionIds[t] = static_cast<int64_t>(t % static_cast<size_t>(shape[1]));
+        }
+
+        vector<Ort::Value> feedVals;
+        for (auto nm : inputNames)
+        {
+            string s(nm);
+            if (s == "input_ids")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(ids->data()), count, shape.data(), shape.size()));
+            else if (s == "attention_mask" && modelHasAttnMask)
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(mask->data()), count, shape.data(), shape.size()));
+            else if (s == "token_type_ids" && modelHasTokenType)
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(types->data()), count, shape.data(), shape.size()));
+            else if (s == "position_ids")
+                feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, positionIds.data(), count, shape.data(), shape.size()));
+            else if (s == "token_type_ids")
+            {
+                cerr << "[inferLLM] token_type_ids ignored (model does not require it)." << std::endl;
+            }
+        }
+
+        auto outs = session->Run(runOptions,
+                                 inputNames.data(), feedVals.data(), feedVals.size(),
+                                 outputNames.data(), outputNames.size());
+
+        auto &out0 = outs.front();
+        auto info = out0.GetTensorTypeAndShapeInfo();
+        result.rawOutputShape = info.GetShape();
+
+        const size_t numel = info.GetElementCount();
+        const float *buf = out0.GetTensorData<float>();
+        result.rawOutput.assign(buf, buf + numel);
+        return true;
+    }
+
+    // BERT GLUE with packing: queries are packed into shared rows, run together and unpacked from
+    // each segment's first-token ([CLS]) logits. Queries whose mask is not right-padded cannot be
+    // packed and get a row of their own.
+    vector<BMTLLMResult> inferPacked(const vector<VariantType> &data)
+    {
+        int64_t rowLength = 0;
+        for (const auto &query : data)
+        {
+            if (const auto *compact = get_if<vector<int32_t>>(&query); compact && isCompactLLMInput(*compact))
+                rowLength = max<int64_t>(rowLength, (*compact)[2]);
+            else if (const auto *in = get_if<LLMPreprocessedInput>(&query))
+                rowLength = max(rowLength, in->S);
+        }
+        packer.reset(static_cast<size_t>(rowLength));
+
+        vector<bool> valid(data.size(), false);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            const int64_t *ids = nullptr;
+            const int64_t *types = nullptr;
+            const int64_t *mask = nullptr;
+            size_t length = 0;
+            if (const auto *compact = get_if<vector<int32_t>>(&data[i]); compact && isCompactLLMInput(*compact) && (*compact)[1] == 1)
+            {
+                expandLLMInput(*compact, scratch);
+                ids = scratch.inputIds.data();
+                types = scratch.hasTypes ? scratch.tokenTypeIds.data() : nullptr;
+                mask = scratch.hasMask ? scratch.attentionMask.data() : nullptr;
+                length = scratch.inputIds.size();
+            }
+            else if (const auto *in = get_if<LLMPreprocessedInput>(&data[i]); in && in->N == 1)
+            {
+                ids = in->input_ids.data();
+                types = in->token_type_ids.size() == in->input_ids.size() ? in->token_type_ids.data() : nullptr;
+                mask = in->attention_mask.size() == in->input_ids.size() ? in->attention_mask.data() : nullptr;
+                length = in->input_ids.size();
+            }
+            else
+            {
+                cerr << "[inferLLM] Invalid VariantType at index " << i << endl;
+                continue;
+            }
+            valid[i] = true;
+            if (mask && !isPrefixMask(mask, length))
+                packer.addAlone(i, ids, types, mask, length);
+            else
+                packer.add(i, ids, types, mask ? validTokenCount(mask, length) : length);
+        }
+
+        vector<BMTLLMResult> results(data.size());
+        const array<int64_t, 2> shape{1, rowLength};
+        const array<int64_t, 3> maskShape{1, rowLength, rowLength};
+        for (size_t r = 0; r < packer.size(); ++r)
+        {
+            const PackedRow &row = packer.row(r);
+            vector<Ort::Value> feedVals;
+            for (auto nm : inputNames)
+            {
+                string s(nm);
+                if (s == "input_ids")
+                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(row.inputIds.data()), row.inputIds.size(), shape.data(), shape.size()));
+                else if (s == "attention_mask")
+                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(row.attentionMask.data()), row.attentionMask.size(), maskShape.data(), maskShape.size()));
+                else if (s == "token_type_ids")
+                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(row.tokenTypeIds.data()), row.tokenTypeIds.size(), shape.data(), shape.size()));
+                else if (s == "position_ids")
+                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(row.positionIds.data()), row.positionIds.size(), shape.data(), shape.size()));
+            }
+
+            auto outs = session->Run(runOptions,
+                                     inputNames.data(), feedVals.data(), feedVals.size(),
+                                     outputNames.data(), outputNames.size());
+
+            // Per-token logits [1, rowLength, labels]
+            auto info = outs.front().GetTensorTypeAndShapeInfo();
+            const int64_t labels = info.GetShape().back();
+            const float *buf = outs.front().GetTensorData<float>();
+            for (const auto &segment : row.segments)
+            {
+                const float *cls = buf + segment.offset * labels;
+                results[segment.query].rawOutput.assign(cls, cls + labels);
+                results[segment.query].rawOutputShape = {1, labels};
+            }
+        }
+
+        // Invalid queries are skipped, as in the unpacked path.
+        vector<BMTLLMResult> ordered;
+        ordered.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (valid[i])
+                ordered.push_back(std::move(results[i]));
+        }
+        return ordered;
+    }
 
 public:
+    virtual ~LLM_Interface_Implementation()
+    {
+        if (batcher)
+        {
+            ContinuousBatcherStats stats = batcher->get_stats();
+            batcher.reset();
+            print_continuous_batcher_stats(stats);
+        }
+    }
+
     virtual InterfaceType getInterfaceType() override
     {
         // return InterfaceType::LLM_GPT2_MMLU;
@@ -39,17 +383,20 @@ public:
     virtual void initialize(string modelPath) override
     {
         // Reset state to avoid residual input/output names from previous sessions
+        batcher.reset();
         inputNameStrs.clear();
         inputNames.clear();
         outputNameStrs.clear();
         outputNames.clear();
         modelHasTokenType = false;
         modelHasAttnMask = false;
+        modelHasPositionIds = false;
 
         // session initializer
         SessionOptions sessionOptions;
         sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
         sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        applyOrtThreadPlacement(sessionOptions); // optional: AI_BMT_INFERENCE_CPUS=0-7
         wstring modelPathwstr(modelPath.begin(), modelPath.end());
         session = make_shared<Session>(env, modelPathwstr.c_str(), sessionOptions);
 
@@ -81,6 +428,31 @@ public:
         // Check if the model has optional inputs
         modelHasTokenType = std::find(inputNameStrs.begin(), inputNameStrs.end(), "token_type_ids") != inputNameStrs.end();
         modelHasAttnMask = std::find(inputNameStrs.begin(), inputNameStrs.end(), "attention_mask") != inputNameStrs.end();
+        modelHasPositionIds = std::find(inputNameStrs.begin(), inputNameStrs.end(), "position_ids") != inputNameStrs.end();
+
+        // BERT GLUE, opt-in (AI_BMT_PACK_SEQUENCES=1): pack several queries per row when the export takes
+        // position_ids and a 3D mask and returns per-token logits. Packed queries return their first-token
+        // logits as [1, labels] instead of the [1, S, labels] an unpacked run returns, so enable it only
+        // where the result is scored from the [CLS] logits.
+        // Optional (AI_BMT_TRIM_PADDING=1), for classifier exports only: run each right-padded query at
+        // its real length, since the classifier reads the first token and trailing padding only costs
+        // compute. Per-token exports are never trimmed, as that would
+        // change their output shape.
+        const bool isBert = getInterfaceType() == InterfaceType::LLM_Bert_GLUE;
+        const bool perTokenOutput = session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape().size() == 3;
+        const char *pack = getenv("AI_BMT_PACK_SEQUENCES");
+        packSequences = isBert && modelHasPositionIds && inputRank("attention_mask") == 3 && perTokenOutput && pack != nullptr && atoi(pack) != 0;
+        const char *trim = getenv("AI_BMT_TRIM_PADDING");
+        trimPadding = isBert && !packSequences && !perTokenOutput && trim != nullptr && atoi(trim) != 0;
+
+        const char *batching = getenv("AI_BMT_CONTINUOUS_BATCHING");
+        useContinuousBatching = batching != nullptr && atoi(batching) != 0;
+        if (const char *budget = getenv("AI_BMT_BATCH_TOKEN_BUDGET"))
+            batchingConfig.token_budget = static_cast<size_t>(max(1, atoi(budget)));
+        if (const char *batchSize = getenv("AI_BMT_BATCH_MAX_SIZE"))
+            batchingConfig.max_batch_size = static_cast<size_t>(max(1, atoi(batchSize)));
+        if (useContinuousBatching && !packSequences)
+            batcher = make_unique<Batcher>([this](vector<Batcher::Sequence *> &batch) { runStep(batch); }, batchingConfig);
     }
 
     virtual Optional_Data getOptionalData() override
@@ -101,6 +473,12 @@ public:
 
     virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
     {
+        // Compact int32 encoding (see compact_llm_input.hpp), moved into the variant.
+        vector<int32_t> compact;
+        if (packLLMInput(llmData, modelHasAttnMask, modelHasTokenType, compact))
+            return compact;
+
+        // Token ids beyond int32: keep the full representation.
         LLMPreprocessedInput in = llmData;
         const size_t S = in.input_ids.size();
         if (modelHasAttnMask && in.attention_mask.size() != S)
@@ -112,52 +490,18 @@ public:
 
     virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
     {
-        vector<BMTLLMResult> results;
+        if (packSequences)
+            return inferPacked(data);
+        if (batcher)
+            return inferBatched(data);
 
+        vector<BMTLLMResult> results;
+        results.reserve(data.size());
         for (size_t i = 0; i < data.size(); ++i)
         {
-            LLMPreprocessedInput in;
-            try
-            {
-                in = get<LLMPreprocessedInput>(data[i]);
-            }
-            catch (const bad_variant_access &e)
-            {
-                cerr << "[inferLLM] Invalid VariantType at index " << i << endl;
-                continue;
-            }
-
-            const array<int64_t, 2> shape{in.N, in.S};
-            vector<Ort::Value> feedVals;
-            for (auto nm : inputNames)
-            {
-                string s(nm);
-                if (s == "input_ids")
-                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(in.input_ids.data()), in.input_ids.size(), shape.data(), shape.size()));
-                else if (s == "attention_mask" && modelHasAttnMask)
-                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(in.attention_mask.data()), in.attention_mask.size(), shape.data(), shape.size()));
-                else if (s == "token_type_ids" && modelHasTokenType)
-                    feedVals.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, const_cast<int64_t *>(in.token_type_ids.data()), in.token_type_ids.size(), shape.data(), shape.size()));
-                else if (s == "token_type_ids")
-                {
-                    cerr << "[inferLLM] token_type_ids ignored (model does not require it)." << std::endl;
-                }
-            }
-
-            auto outs = session->Run(runOptions,
-                                     inputNames.data(), feedVals.data(), feedVals.size(),
-                                     outputNames.data(), outputNames.size());
-
             BMTLLMResult r;
-            auto &out0 = outs.front();
-            auto info = out0.GetTensorTypeAndShapeInfo();
-            r.rawOutputShape = info.GetShape();
-
-            const size_t numel = info.GetElementCount();
-            const float *buf = out0.GetTensorData<float>();
-            r.rawOutput.assign(buf, buf + numel);
-
-            results.push_back(r);
+            if (inferOne(data[i], i, r))
+                results.push_back(std::move(r));
         }
 
         return results;
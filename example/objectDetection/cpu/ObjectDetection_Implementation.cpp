@@ -10,6 +10,12 @@
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 #include <filesystem>
+#include "../../common/letterbox.hpp"
+#include "../../common/preprocess_pipeline.hpp"
+#include "../../common/ort_thread_placement.hpp"
+#include "../../common/dataset_readahead.hpp"
+#include "../../common/yolo_decoder.hpp"
+#include "../../common/vision_output_buffer.hpp"
 
 using namespace std;
 using namespace cv;
@@ -26,6 +32,17 @@ private:
     array<const char*, 1> inputNames;
     array<const char*, 1> outputNames;
     MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+    shared_ptr<DatasetReadahead> readahead = datasetReadaheadFromEnvironment(); // AI_BMT_READAHEAD_LIST, otherwise null; shared per process
+
+    // Model input size and letterbox padding value (YOLO convention: gray 114).
+    const int inputWidth = 640;
+    const int inputHeight = 640;
+    const float padValue = 114.0f / 255.0f;
+
+    // Output layout, read from the model in initialize(): (1, 25200, 85) Yolov5, (1, 84, 8400) Yolov5u/8/9/11/12,
+    // (1, 300, 6) Yolov10. Switching model families needs no source change.
+    YoloOutputLayout outputLayout;
+    size_t outputSize = 0;
 
 public:
     virtual InterfaceType getInterfaceType() override
@@ -39,6 +56,7 @@ public:
         SessionOptions sessionOptions;
         sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
         sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        applyOrtThreadPlacement(sessionOptions); // optional: AI_BMT_INFERENCE_CPUS=0-7
         wstring modelPathwstr(modelPath.begin(), modelPath.end());
         session = make_shared<Session>(env, modelPathwstr.c_str(), sessionOptions);
 
@@ -50,6 +68,29 @@ public:
         outputNames = { outputName.get() };
         inputName.release();
         outputName.release();
+
+        outputLayout = detectYoloLayout(session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape());
+        outputSize = outputLayout.elements();
+        cout << "Detection output (" << outputLayout.shape[1] << ", " << outputLayout.shape[2] << "): " << yoloLayoutName(outputLayout.layout) << " layout" << endl;
+    }
+
+    // Decodes a raw output of this model (any layout, read in place) into NMS-filtered boxes in
+    // pixels of the 640x640 input image, for submitters that check or post-process detections themselves.
+    vector<Coco17DetectionResult> decodeDetections(const float* output, float confThreshold = 0.25f, float iouThreshold = 0.45f)
+    {
+        thread_local YoloDecoder decoder;
+        thread_local vector<YoloDetection> boxes;
+        if (decoder.outputLayout().shape != outputLayout.shape) decoder = YoloDecoder(outputLayout);
+
+        decoder.decode(output, confThreshold, boxes);
+        decoder.suppress(boxes, iouThreshold);
+
+        vector<Coco17DetectionResult> results;
+        results.reserve(boxes.size());
+        for (const YoloDetection& box : boxes) {
+            results.emplace_back(box.classId, box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1, box.score);
+        }
+        return results;
     }
 
     virtual Optional_Data getOptionalData() override
@@ -71,62 +112,63 @@ public:
     virtual VariantType preprocessVisionData(const string& imagePath) override
     {
         // Load padded image
-        Mat image = imread(imagePath);
+        Mat image = loadImage(readahead.get(), imagePath);
         if (image.empty()) {
             cerr << "Image not found at: " << imagePath << endl;
             throw runtime_error("Image not found!");
         }
 
-        //Convert to float and normalize
-        Mat floatImg;
-        image.convertTo(floatImg, CV_32FC3, 1.0 / 255.0);
-        cvtColor(floatImg, floatImg, COLOR_BGR2RGB);
-
-        //HWC → CHW
-        vector<Mat> chw;
-        split(floatImg, chw);
-        vector<float> inputTensorValues;
-        for (int c = 0; c < 3; ++c) {
-            inputTensorValues.insert(inputTensorValues.end(),
-                (float*)chw[c].datastart, (float*)chw[c].dataend);
+        // The driver scores the raw output in 640x640 input coordinates against annotations of the
+        // padded images, so other sizes (unpadded custom datasets) must be padded offline first.
+        if (image.cols != inputWidth || image.rows != inputHeight) {
+            throw runtime_error("Unexpected image size (" + to_string(image.cols) + "x" + to_string(image.rows) + "), expected a padded 640x640 image: " + imagePath);
         }
+
+        // One pass: BGR -> RGB, [0, 255] -> [0, 1], HWC -> CHW (the letterbox's identity path)
+        vector<float> inputTensorValues(3 * inputHeight * inputWidth);
+        letterboxToCHW<float>(image.data, image.cols, image.rows, image.step,
+                              inputWidth, inputHeight, true, 1.0f / 255.0f, padValue,
+                              inputTensorValues.data());
         return inputTensorValues;
     }
 
+    // Runs query `index`; ORT writes the raw output straight into `output` (a result vector or a driver buffer).
+    void runQuery(const vector<VariantType>& data, size_t index, float* output)
+    {
+        array<int64_t, 4> inputShape = { 1, 3, inputHeight, inputWidth };
+
+        const size_t inputSize = static_cast<size_t>(3) * inputHeight * inputWidth;
+        if (!holds_alternative<vector<float>>(data[index]) && !holds_alternative<float*>(data[index])) {
+            throw runtime_error("Error: bad_variant_access at index " + to_string(index) + ": query is not vector<float> or float*");
+        }
+        const float* imageData = visionInputData(data[index], inputSize);
+        auto inputTensor = Ort::Value::CreateTensor<float>(memory_info, const_cast<float*>(imageData), inputSize, inputShape.data(), inputShape.size());
+        auto outputTensor = Value::CreateTensor<float>(memory_info, output, outputSize, outputLayout.shape.data(), outputLayout.shape.size());
+
+        // Run inference
+        session->Run(runOptions, inputNames.data(), &inputTensor, 1, outputNames.data(), &outputTensor, 1);
+    }
+
     virtual vector<BMTVisionResult> inferVision(const vector<VariantType>& data) override
     {
-        //onnx option setting
-        const int querySize = data.size();
-        vector<BMTVisionResult> results;
-        array<int64_t, 4> inputShape = { 1, 3, 640, 640 };
-
-        array<int64_t, 3> outputShape = { 1, 25200, 85 }; //Yolov5
-        //array<int64_t, 3> outputShape = { 1, 84, 8400 }; //Yolov5u, Yolov8, Yolov9, Yolo11, Yolo12
-        //array<int64_t, 3> outputShape = { 1, 300, 6 }; //Yolov10
-
-        for (int i = 0; i < querySize; i++) {
-            vector<float> imageVec;
-            try {
-                imageVec = get<vector<float>>(data[i]);
-            }
-            catch (const std::bad_variant_access& e) {
-                string errorMessage = "Error: bad_variant_access at index " + to_string(i) + ": " + e.what();
-                throw runtime_error(errorMessage.c_str());
-            }
-            vector<float> outputData(outputShape[1] * outputShape[2]);
-            auto inputTensor = Ort::Value::CreateTensor<float>(memory_info, imageVec.data(), imageVec.size(), inputShape.data(), inputShape.size());
-            auto outputTensor = Value::CreateTensor<float>(memory_info, outputData.data(), outputData.size(), outputShape.data(), outputShape.size());
-
-            // Run inference
-            session->Run(runOptions, inputNames.data(), &inputTensor, 1, outputNames.data(), &outputTensor, 1);
-
-            // Update results
-            BMTVisionResult result;
-            result.objectDetectionResult = outputData;
-            results.push_back(result);
+        vector<BMTVisionResult> results(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            results[i].objectDetectionResult.resize(outputSize);
+            runQuery(data, i, results[i].objectDetectionResult.data());
         }
         return results;
     }
+
+    // Writes query i's raw YOLO output into outputs[i]; not an AI_BMT_Interface override (see vision_output_buffer.hpp).
+    void inferVisionInto(const vector<VariantType>& data, const vector<VisionOutputBuffer>& outputs)
+    {
+        if (data.size() != outputs.size()) throw runtime_error("inferVisionInto(..): one output buffer per query is required");
+
+        for (size_t i = 0; i < data.size(); i++) {
+            if (outputs[i].size != outputSize) throw runtime_error("inferVisionInto(..): output buffer " + to_string(i) + " must hold " + to_string(outputSize) + " elements");
+            runQuery(data, i, outputs[i].data);
+        }
+    }
 };
 
 
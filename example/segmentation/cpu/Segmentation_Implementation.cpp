@@ -10,6 +10,11 @@
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 #include <filesystem>
+#include "../../common/preprocess_pipeline.hpp"
+#include "../../common/ort_thread_placement.hpp"
+#include "../../common/dataset_readahead.hpp"
+#include "../../common/segmentation_upsample.hpp"
+#include "../../common/vision_output_buffer.hpp"
 
 using namespace std;
 using namespace cv;
@@ -25,6 +30,19 @@ private:
     array<const char *, 1> outputNames;
     MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
     string modelPath;
+    PreprocessEntry preprocessor; // resolved once in initialize()
+    shared_ptr<DatasetReadahead> readahead = datasetReadaheadFromEnvironment(); // AI_BMT_READAHEAD_LIST, otherwise null; shared per process
+
+    // Output size of the result (21 x 520 x 520) and of the model's logits, which efficient models
+    // emit at 1/4 or 1/8 resolution; those are upsampled and reduced by `upsampler` in one pass.
+    // `upsampler` is immutable after initialize(); the buffers each call needs are thread_local in
+    // runQuery, so concurrent inferVision calls (e.g. under Pooled_Submitter) do not share them.
+    static constexpr int numClasses = 21;
+    static constexpr int outputHeight = 520;
+    static constexpr int outputWidth = 520;
+    int64_t logitsHeight = outputHeight;
+    int64_t logitsWidth = outputWidth;
+    unique_ptr<const UpsampleArgmax> upsampler; // null when the model outputs full-resolution logits
 
 public:
     virtual InterfaceType getInterfaceType() override
@@ -40,6 +58,7 @@ public:
         SessionOptions sessionOptions;
         sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
         sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        applyOrtThreadPlacement(sessionOptions); // optional: AI_BMT_INFERENCE_CPUS=0-7
         wstring modelPathwstr(modelPath.begin(), modelPath.end());
         session = make_shared<Session>(env, modelPathwstr.c_str(), sessionOptions);
 
@@ -51,6 +70,18 @@ public:
         outputNames = {outputName.get()};
         inputName.release();
         outputName.release();
+
+        preprocessor = selectPreprocessor(getInterfaceType(), modelPath);
+
+        // Logits resolution from the model's output shape (1, 21, H, W); dynamic dimensions are
+        // taken to be full resolution.
+        const vector<int64_t> modelOutputShape = session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        logitsHeight = modelOutputShape.size() == 4 && modelOutputShape[2] > 0 ? modelOutputShape[2] : outputHeight;
+        logitsWidth = modelOutputShape.size() == 4 && modelOutputShape[3] > 0 ? modelOutputShape[3] : outputWidth;
+        if (logitsHeight != outputHeight || logitsWidth != outputWidth)
+        {
+            upsampler = make_unique<const UpsampleArgmax>(numClasses, static_cast<int>(logitsHeight), static_cast<int>(logitsWidth), outputHeight, outputWidth);
+        }
     }
 
     virtual Optional_Data getOptionalData() override
@@ -71,78 +102,99 @@ public:
 
     virtual VariantType preprocessVisionData(const string &imagePath) override
     {
-        Mat image = imread(imagePath);
+        Mat image = loadImage(readahead.get(), imagePath);
         if (image.empty())
         {
             throw runtime_error("Failed to load image: " + imagePath);
         }
 
-        // convert BGR to RGB before reshaping
-        cvtColor(image, image, cv::COLOR_BGR2RGB);
-
-        // reshape (3D -> 1D)
-        image = image.reshape(1, 1);
-
-        // uint_8, [0, 255] -> float, [0 and 1] => Normalize number to between 0 and 1, Convert to vector<float> from cv::Mat.
-        vector<float> vec;
-        image.convertTo(vec, CV_32FC1, 1. / 255);
-
-        const bool isDeeplabMobileNetv2 = ((modelPath.find("v2") != std::string::npos) || (modelPath.find("V2") != std::string::npos));
-        const vector<float> means = isDeeplabMobileNetv2 ? std::vector<float>{0.5f, 0.5f, 0.5f} : vector<float>{0.485f, 0.456f, 0.406f};
-        const vector<float> stds = isDeeplabMobileNetv2 ? std::vector<float>{0.5f, 0.5f, 0.5f} : vector<float>{0.229f, 0.224f, 0.225f};
-
-        // Transpose (Height, Width, Channel)(224,224,3) to (Chanel, Height, Width)(3,224,224)
-        vector<float> output;
-        for (size_t ch = 0; ch < 3; ++ch)
+        if (image.cols != preprocessor.width || image.rows != preprocessor.height)
         {
-            for (size_t i = ch; i < vec.size(); i += 3)
-            {
-                float normalized = (vec[i] - means[ch]) / stds[ch];
-                output.emplace_back(normalized);
-            }
+            throw runtime_error("Unexpected image size (" + to_string(image.cols) + "x" + to_string(image.rows) + "): " + imagePath);
         }
+
+        // BGR -> RGB, [0, 255] -> normalized float, HWC (520,520,3) -> CHW (3,520,520) in a single pass.
+        // The normalization constants (ImageNet or DeepLabV3-MobileNetV2) were selected in initialize().
+        vector<float> output(preprocessor.outputSize());
+        preprocessor.run(image.data, image.step, output.data());
         return output;
     }
 
+    // Runs one query; ORT writes the 21 x 520 x 520 logits straight into `output`
+    // (a result vector or a driver buffer), so the 22 MB output is never copied.
+    // Low-resolution logits go to a small per-thread buffer instead, and `output` receives the one-hot
+    // scores of the upsampled argmax, which score the same as full-resolution logits.
+    void runQuery(const VariantType &query, float *output)
+    {
+        // onnx option setting
+        const vector<int64_t> input_dims = {1, 3, 520, 520};
+        const vector<int64_t> output_shape = {1, numClasses, logitsHeight, logitsWidth};
+        thread_local vector<float> lowResLogits;
+        thread_local UpsampleScratch upsampleScratch;
+        if (upsampler)
+            lowResLogits.resize(static_cast<size_t>(numClasses) * logitsHeight * logitsWidth);
+        float *logits = upsampler ? lowResLogits.data() : output;
+
+        const size_t inputSize = preprocessor.outputSize();
+        const float *imageData = visionInputData(query, inputSize);
+        auto input_tensor = Ort::Value::CreateTensor<float>(
+            memory_info, const_cast<float *>(imageData), inputSize, input_dims.data(), input_dims.size());
+
+        auto output_tensor = Ort::Value::CreateTensor<float>(
+            memory_info, logits, output_shape[1] * output_shape[2] * output_shape[3],
+            output_shape.data(), output_shape.size());
+
+        session->Run(runOptions, inputNames.data(), &input_tensor, 1, outputNames.data(), &output_tensor, 1);
+
+        if (upsampler)
+            upsampler->toOneHotScores(logits, output, upsampleScratch);
+    }
+
     virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
     {
         const int querySize = data.size();
         vector<BMTVisionResult> results;
-
-        // onnx option setting
-        const vector<int64_t> input_dims = {1, 3, 520, 520};
-        const vector<int64_t> output_shape = {1, 21, 520, 520};
+        results.reserve(querySize);
 
         for (int i = 0; i < querySize; ++i)
         {
-            // Prepare input/output tensors
-            vector<float> imageVec;
+            BMTVisionResult result;
+            result.segmentationResult.resize(21 * 520 * 520);
             try
             {
-                imageVec = get<vector<float>>(data[i]);
+                runQuery(data[i], result.segmentationResult.data());
             }
             catch (const std::bad_variant_access &e)
             {
                 cerr << "Error: bad_variant_access at index " << i << ". Reason: " << e.what() << endl;
                 continue;
             }
+            results.push_back(move(result));
+        }
+        return results;
+    }
 
-            vector<float> output_data(output_shape[1] * output_shape[2] * output_shape[3]);
-            auto input_tensor = Ort::Value::CreateTensor<float>(
-                memory_info, imageVec.data(), imageVec.size(), input_dims.data(), input_dims.size());
-
-            auto output_tensor = Ort::Value::CreateTensor<float>(
-                memory_info, output_data.data(), output_data.size(),
-                output_shape.data(), output_shape.size());
-
-            session->Run(runOptions, inputNames.data(), &input_tensor, 1, outputNames.data(), &output_tensor, 1);
+    // Writes query i's 21 x 520 x 520 scores into outputs[i]; not an AI_BMT_Interface override (see
+    // vision_output_buffer.hpp). A query that is not a float vector throws, since its buffer would
+    // otherwise be left unwritten.
+    void inferVisionInto(const vector<VariantType> &data, const vector<VisionOutputBuffer> &outputs)
+    {
+        if (data.size() != outputs.size())
+            throw runtime_error("inferVisionInto(..): one output buffer per query is required");
 
-            // Update results
-            BMTVisionResult result;
-            result.segmentationResult = output_data;
-            results.push_back(result);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (outputs[i].size != 21 * 520 * 520)
+                throw runtime_error("inferVisionInto(..): output buffer " + to_string(i) + " must hold 21 x 520 x 520 elements");
+            try
+            {
+                runQuery(data[i], outputs[i].data);
+            }
+            catch (const std::bad_variant_access &e)
+            {
+                throw runtime_error("inferVisionInto(..): bad_variant_access at index " + to_string(i) + ". Reason: " + e.what());
+            }
         }
-        return results;
     }
 };
 
@@ -87,6 +87,11 @@ int main(int argc, char *argv[])
         // shared_ptr<AI_BMT_Interface> interface = make_shared<Segmentation_Interface_Implementation>();
         // shared_ptr<AI_BMT_Interface> interface = make_shared<Segmentation_CustomDataset_Interface_Implementation>();
         // shared_ptr<AI_BMT_Interface> interface = make_shared<LLM_Interface_Implementation>();
+        // shared_ptr<AI_BMT_Interface> interface = make_sharded_submitter<ImageClassification_Interface_Implementation>(4); // utils/sharded_submitter.hpp, one model instance per device/session
+        // shared_ptr<AI_BMT_Interface> interface = make_shared<Warmup_Submitter_Implementation>(make_shared<ImageClassification_Interface_Implementation>()); // utils/warmup_submitter.hpp, warm up until steady state
+        // shared_ptr<AI_BMT_Interface> interface = make_shared<Synthetic_Submitter_Implementation>(); // utils/synthetic_submitter.hpp, no model: measures harness overhead for any InterfaceType
+        // shared_ptr<AI_BMT_Interface> interface = make_shared<Telemetry_Submitter_Implementation>(make_shared<ImageClassification_Interface_Implementation>(), "telemetry_report.json"); // utils/thermal_telemetry.cpp, frequency/temperature/throttling vs latency
+        // shared_ptr<AI_BMT_Interface> interface = make_shared<Run_Recording_Submitter_Implementation>(make_shared<ImageClassification_Interface_Implementation>(), "run_candidate.json"); // utils/run_report.cpp, compare runs with benchmark/compare_runs
         return AI_BMT_GUI_CALLER::call_BMT_GUI_For_Single_Task(argc, argv, interface);
 
         // -- For Multi-Domain Tasks --
@@ -99,6 +104,17 @@ int main(int argc, char *argv[])
             make_shared<LLM_Interface_Implementation>(),
         };
         return AI_BMT_GUI_CALLER::call_BMT_GUI_For_Multiple_Tasks(argc, argv, interfaceVector);
+
+        // Same tasks sharing one work-stealing pool (utils/work_stealing_pool.hpp), cheap tasks first:
+        auto pool = make_shared<WorkStealingPool>();
+        vector<shared_ptr<AI_BMT_Interface>> pooledInterfaceVector
+        {
+            make_shared<Pooled_Submitter_Implementation>(make_shared<ImageClassification_Interface_Implementation>(), pool, TaskHints{TaskPriority::High}),
+            make_shared<Pooled_Submitter_Implementation>(make_shared<ObjectDetection_Interface_Implementation>(), pool),
+            make_shared<Pooled_Submitter_Implementation>(make_shared<Segmentation_Interface_Implementation>(), pool, TaskHints{TaskPriority::Low}),
+            make_shared<Pooled_Submitter_Implementation>(make_shared<LLM_Interface_Implementation>(), pool, TaskHints{}, 0),
+        };
+        return AI_BMT_GUI_CALLER::call_BMT_GUI_For_Multiple_Tasks(argc, argv, pooledInterfaceVector);
         */
     }
     catch (const exception &ex)
@@ -1,32 +1,19 @@
 #include "async_inference.hpp"
 #include "utils.hpp"
 
-#if defined(__unix__)
-#include <sys/mman.h>
-#endif
-
-
-static std::shared_ptr<uint8_t> page_aligned_alloc(size_t size, void* buff = nullptr) {
-    #if defined(__unix__)
-        auto addr = mmap(buff, size, PROT_WRITE | PROT_READ, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-        if (MAP_FAILED == addr) throw std::bad_alloc();
-        return std::shared_ptr<uint8_t>(reinterpret_cast<uint8_t*>(addr), [size](void *addr) { munmap(addr, size); });
-    #elif defined(_MSC_VER)
-        auto addr = VirtualAlloc(buff, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        if (!addr) throw std::bad_alloc();
-        return std::shared_ptr<uint8_t>(reinterpret_cast<uint8_t*>(addr), [](void *addr){ VirtualFree(addr, 0, MEM_RELEASE); });
-    #else
-    #pragma error("Aligned alloc not supported")
-    #endif
-}
+#include <unistd.h>
+
 size_t align_to_page_size(size_t size) {
     const size_t page_size = sysconf(_SC_PAGE_SIZE);  // For Unix-like systems
     return (size + page_size - 1) & ~(page_size - 1);  // Round up to the nearest page boundary
 }
 
 AsyncModelInfer::AsyncModelInfer(const std::string &hef_path,
-                                 std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> results_queue)
+                                 std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> results_queue,
+                                 size_t max_in_flight)
 {
+    set_max_in_flight(max_in_flight);
+
     auto vdevice_exp = hailort::VDevice::create();
     if (!vdevice_exp) {
         std::cerr << "Failed to create VDevice, status = " << vdevice_exp.status() << std::endl;
@@ -46,8 +33,6 @@ AsyncModelInfer::AsyncModelInfer(const std::string &hef_path,
     for (auto& output : outputs) {
         output.set_format_type(HAILO_FORMAT_TYPE_FLOAT32);
     }
-    this->input_buffer_guards.reserve(this->infer_model->inputs().size());
-    this->output_buffer_guards.reserve(this->infer_model->outputs().size());
 
     for (auto& output_vstream_info : this->infer_model->hef().get_output_vstream_infos().release()) {
         std::string name(output_vstream_info.name);
@@ -81,8 +66,6 @@ void AsyncModelInfer::PathAndResult(const std::string &hef_path)
         output.set_format_type(HAILO_FORMAT_TYPE_FLOAT32);
     }
     infer_model->set_batch_size(32);
-    this->input_buffer_guards.reserve(this->infer_model->inputs().size());
-    this->output_buffer_guards.reserve(this->infer_model->outputs().size());
 
     for (auto& output_vstream_info : this->infer_model->hef().get_output_vstream_infos().release()) {
         std::string name(output_vstream_info.name);
@@ -105,90 +88,134 @@ const std::shared_ptr<hailort::InferModel> AsyncModelInfer::get_infer_model(){
 
 void AsyncModelInfer::configure(std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> output_data_queue) { 
 
-    this->configured_infer_model = this->infer_model->configure().expect("Failed to create configured infer model");
-    this->bindings = configured_infer_model.create_bindings().expect("Failed to create infer bindings");
+    this->backend = std::make_shared<HailoInferBackend>(this->infer_model);
     this->output_data_queue = std::move(output_data_queue);
+
+    // Completed jobs are published with their vstream infos; the item keeps the output buffers alive.
+    std::vector<hailo_vstream_info_t> output_infos;
+    for (const auto &output : backend->output_infos()) {
+        output_infos.push_back(output_vstream_info_by_name[output.name]);
+    }
+    auto queue = this->output_data_queue;
+    this->pipeline = std::make_unique<AsyncInferPipeline>(backend,
+        [queue, output_infos](AsyncOutputItem &&completed)
+        {
+            InferenceOutputItem item;
+            item.frame_idx = completed.frame_idx;
+            for (size_t i = 0; i < completed.outputs.size(); ++i) {
+                item.output_data_and_infos.push_back(std::make_pair(completed.outputs[i].data, output_infos[i]));
+            }
+            item.output_guards = std::move(completed.output_guards);
+            item.status = completed.success ? HAILO_SUCCESS : HAILO_INTERNAL_FAILURE;
+            queue->push(std::move(item));
+        },
+        max_in_flight);
 }
 
 std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> AsyncModelInfer::get_queue(){
     return output_data_queue;
 }
 
-void AsyncModelInfer::infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx) 
-{
-    set_input_buffers(input_data);
-    auto output_data_and_infos = prepare_output_buffers();
-    wait_and_run_async(frame_idx, output_data_and_infos);
+std::shared_ptr<InferBackend> AsyncModelInfer::get_backend(){
+    return backend;
 }
 
-void AsyncModelInfer::set_input_buffers(const std::shared_ptr<std::vector<uint8_t>> &input_data)
+AsyncInferStats AsyncModelInfer::get_stats() const
 {
-    for (const auto &input_name : infer_model->get_input_names()) {
-        size_t frame_size = infer_model->input(input_name)->get_frame_size();
-        //std::cout<<frame_size<<std::endl;
+    return pipeline ? pipeline->get_stats() : AsyncInferStats();
+}
 
-        auto status = bindings.input(input_name)->set_buffer(MemoryView(input_data->data(), frame_size));
-        if (HAILO_SUCCESS != status) {
-            std::cerr << "Failed to set infer input buffer, status = " << status << std::endl;
-        }
-        input_buffer_guards.push_back(input_data);
+void AsyncModelInfer::set_max_in_flight(size_t max_in_flight)
+{
+    this->max_in_flight = max_in_flight;
+    if (pipeline) {
+        pipeline->set_max_in_flight(max_in_flight);
     }
 }
 
-std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> AsyncModelInfer::prepare_output_buffers()
+bool AsyncModelInfer::wait_for_in_flight(std::chrono::milliseconds timeout)
 {
-    std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> result;
-    for (const auto &output_name : infer_model->get_output_names()) {
-        size_t frame_size = infer_model->output(output_name)->get_frame_size();
-        //size_t aligned_frame_size = align_to_page_size(frame_size);
-        output_data_holder = page_aligned_alloc(frame_size);
-        //std::cout <<frame_size<<std::endl;
-        auto status = bindings.output(output_name)->set_buffer(MemoryView(output_data_holder.get(), frame_size));
-
-        if (HAILO_SUCCESS != status) {
-            std::cerr << "Failed to set infer output buffer, status = " << status << std::endl;
-        }
-
-        result.push_back(std::make_pair(
-            bindings.output(output_name)->get_buffer()->data(),
-            output_vstream_info_by_name[output_name]
-        ));
+    return !pipeline || pipeline->wait_for_in_flight(timeout);
+}
 
-        output_buffer_guards.push_back(output_data_holder);
+hailo_status AsyncModelInfer::infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx) 
+{
+    if (!pipeline) {
+        std::cerr << "AsyncModelInfer::infer called before configure()" << std::endl;
+        return HAILO_INVALID_OPERATION;
+    }
+    switch (pipeline->infer(std::move(input_data), frame_idx)) {
+        case BackendStatus::Success: return HAILO_SUCCESS;
+        case BackendStatus::Timeout: return HAILO_TIMEOUT;
+        default:                     return HAILO_INTERNAL_FAILURE;
     }
-
-    return result;
 }
 
 void AsyncModelInfer::clear()
 {
-    input_buffer_guards.clear();
-    output_buffer_guards.clear();
-    output_data_holder.reset(); // page_aligned_alloc 한 output_data도 초기화
+    // Buffers are owned per job and released on completion; clearing only has to drain.
+    if (!wait_for_in_flight(AsyncInferPipeline::ASYNC_READY_TIMEOUT)) {
+        std::cerr << "clear() timed out waiting for in-flight jobs" << std::endl;
+    }
 }
 
-void AsyncModelInfer::wait_and_run_async(size_t frame_idx,
-    const std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> &output_data_and_infos)
+HailoInferBackend::HailoInferBackend(std::shared_ptr<hailort::InferModel> infer_model)
+    : infer_model(std::move(infer_model))
 {
-    auto status = configured_infer_model.wait_for_async_ready(std::chrono::milliseconds(1000));
+    this->configured_infer_model = this->infer_model->configure().expect("Failed to create configured infer model");
+    this->bindings = configured_infer_model.create_bindings().expect("Failed to create infer bindings");
+
+    for (const auto &input_name : this->infer_model->get_input_names()) {
+        inputs.push_back({input_name, this->infer_model->input(input_name)->get_frame_size()});
+    }
+    for (const auto &output_name : this->infer_model->get_output_names()) {
+        outputs.push_back({output_name, this->infer_model->output(output_name)->get_frame_size()});
+    }
+}
+
+BackendStatus HailoInferBackend::wait_for_ready(std::chrono::milliseconds timeout)
+{
+    auto status = configured_infer_model.wait_for_async_ready(timeout);
     if (HAILO_SUCCESS != status) {
         std::cerr << "Failed wait_for_async_ready, status = " << status << std::endl;
+        return (HAILO_TIMEOUT == status) ? BackendStatus::Timeout : BackendStatus::Failure;
+    }
+    return BackendStatus::Success;
+}
+
+BackendStatus HailoInferBackend::run_async(const std::vector<BufferView> &input_buffers,
+                                           const std::vector<BufferView> &output_buffers,
+                                           CompletionCallback on_done)
+{
+    std::lock_guard<std::mutex> lock(bindings_mutex);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto status = bindings.input(inputs[i].name)->set_buffer(MemoryView(input_buffers[i].data, input_buffers[i].size));
+        if (HAILO_SUCCESS != status) {
+            std::cerr << "Failed to set infer input buffer, status = " << status << std::endl;
+            return BackendStatus::Failure;
+        }
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        auto status = bindings.output(outputs[i].name)->set_buffer(MemoryView(output_buffers[i].data, output_buffers[i].size));
+        if (HAILO_SUCCESS != status) {
+            std::cerr << "Failed to set infer output buffer, status = " << status << std::endl;
+            return BackendStatus::Failure;
+        }
     }
-    InferenceOutputItem item;
-    item.frame_idx = frame_idx;
-    item.output_data_and_infos = output_data_and_infos;
 
     auto job = configured_infer_model.run_async(
         bindings,
-        [this, item](const hailort::AsyncInferCompletionInfo& info)
+        [on_done](const hailort::AsyncInferCompletionInfo& info)
         {
-            get_queue()->push(item);
+            on_done(HAILO_SUCCESS == info.status);
         }
     );
 
     if (!job) {
         std::cerr << "Failed to start async infer job, status = " << job.status() << std::endl;
+        return BackendStatus::Failure;
     }
 
     job->detach();
+    return BackendStatus::Success;
 }
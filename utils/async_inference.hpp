@@ -3,6 +3,8 @@
 
 #include "hailo/hailort.hpp"
 #include "utils.hpp"
+#include "bounded_queue.hpp"
+#include "async_pipeline.hpp"
 #include <vector>  
 
 #include <iostream>
@@ -12,125 +14,80 @@
 #include <opencv2/imgcodecs.hpp>
 
 #include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <atomic>
+#include <map>
+#include <chrono>
 
 using namespace hailort;
 
-template<typename T>
-class BoundedTSQueue {
-private:
-    std::queue<T> m_queue;
-    std::mutex m_mutex;
-    std::condition_variable m_cond_not_empty;
-    std::condition_variable m_cond_not_full;
-    const size_t m_max_size;
-    bool m_stopped;
-
-public:
-    explicit BoundedTSQueue(size_t max_size) : m_max_size(max_size), m_stopped(false) {}
-    ~BoundedTSQueue() { stop(); reset(); }
-
-    BoundedTSQueue(const BoundedTSQueue&) = delete;
-    BoundedTSQueue& operator=(const BoundedTSQueue&) = delete;
-
-    void push(T item) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cond_not_full.wait(lock, [this] { return m_queue.size() < m_max_size || m_stopped; });
-        if (m_stopped) return;
-
-        m_queue.push(std::move(item));
-        m_cond_not_empty.notify_one();
-    }
-
-    bool pop(T &out_item) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cond_not_empty.wait(lock, [this] { return !m_queue.empty() || m_stopped; });
-        if (m_stopped && m_queue.empty()) {
-            return false;
-        }
-
-        out_item = std::move(m_queue.front());
-        m_queue.pop();
-        m_cond_not_full.notify_one();
-        return true;
-    }
+// InferBackend over a HailoRT ConfiguredInferModel.
+class HailoInferBackend : public InferBackend {
+    private:
+        std::shared_ptr<hailort::InferModel> infer_model;
+        hailort::ConfiguredInferModel configured_infer_model;
+        hailort::ConfiguredInferModel::Bindings bindings;
+        std::mutex bindings_mutex;
+        std::vector<TensorInfo> inputs;
+        std::vector<TensorInfo> outputs;
 
-    void stop() {
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_stopped = true;
-        }
-        m_cond_not_empty.notify_all();
-        m_cond_not_full.notify_all();
-    }
-    void reset() {
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            // Clear the queue
-            while (!m_queue.empty()) {
-                m_queue.pop();
-            }
-            // Reset the stopped flag and conditions
-            m_stopped = false;
-        }
-        // Notify all waiting threads that they can continue now that the queue is "fresh"
-        m_cond_not_empty.notify_all();
-        m_cond_not_full.notify_all();
-    }
-    bool empty() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_queue.empty();
-    }
+    public:
+        explicit HailoInferBackend(std::shared_ptr<hailort::InferModel> infer_model);
+
+        const std::vector<TensorInfo> &input_infos() const override { return inputs; }
+        const std::vector<TensorInfo> &output_infos() const override { return outputs; }
+        BackendStatus wait_for_ready(std::chrono::milliseconds timeout) override;
+        BackendStatus run_async(const std::vector<BufferView> &input_buffers,
+                                const std::vector<BufferView> &output_buffers,
+                                CompletionCallback on_done) override;
 };
 
-
+// HailoRT front-end of AsyncInferPipeline: owns the VDevice and InferModel and publishes completed
+// frames as InferenceOutputItem (output buffers paired with their vstream infos).
 class AsyncModelInfer {
     private:
         std::unique_ptr<hailort::VDevice> vdevice;
 
         std::shared_ptr<hailort::InferModel> infer_model;
-        hailort::ConfiguredInferModel configured_infer_model;
-        hailort::ConfiguredInferModel::Bindings bindings;
-
-        std::vector<std::shared_ptr<std::vector<uint8_t>>> input_buffer_guards;
-        std::vector<std::shared_ptr<uint8_t>> output_buffer_guards;
+        std::shared_ptr<HailoInferBackend> backend;
         
         std::map<std::string, hailo_vstream_info_t> output_vstream_info_by_name;
-        std::shared_ptr<uint8_t> output_data_holder;
        
         std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> output_data_queue;
 
+        size_t max_in_flight = AsyncInferPipeline::DEFAULT_MAX_IN_FLIGHT;
+        // Declared last so it is destroyed (and drained) before the backend and device.
+        std::unique_ptr<AsyncInferPipeline> pipeline;
+
     public:
         // Constructors
         AsyncModelInfer() = default; // Default constructor
-        AsyncModelInfer(std::shared_ptr<hailort::InferModel> infer_model);
         AsyncModelInfer(const std::string &hef_path,
-                    std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> results_queue);
+                    std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> results_queue,
+                    size_t max_in_flight = AsyncInferPipeline::DEFAULT_MAX_IN_FLIGHT);
 
         AsyncModelInfer(const AsyncModelInfer&) = delete; // Copy constructor (deleted because of shared_ptr)
         AsyncModelInfer& operator=(const AsyncModelInfer&) = delete; // Copy assignment operator (deleted because of shared_ptr)
         AsyncModelInfer(AsyncModelInfer&& other) noexcept = default; // Move constructor
         AsyncModelInfer& operator=(AsyncModelInfer&& other) noexcept = default; // Move assignment
-        ~AsyncModelInfer() = default; // Destructor
+        ~AsyncModelInfer() = default; // Destructor (the pipeline waits for in-flight jobs)
 
         // Getters
         const std::vector<hailort::InferModel::InferStream>& get_inputs();
         const std::vector<hailort::InferModel::InferStream>& get_outputs();
         const std::shared_ptr<hailort::InferModel> get_infer_model();
         std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> get_queue();
+        std::shared_ptr<InferBackend> get_backend();
+        AsyncInferStats get_stats() const;
 
         // Functions
         void PathAndResult(const std::string &hef_path);
         void configure(std::shared_ptr<BoundedTSQueue<InferenceOutputItem>> output_data_queue);
-        void infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx);
+        // Blocks while max_in_flight jobs are outstanding (backpressure), then submits the frame.
+        hailo_status infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx);
         void crt();
-        //Helpers
-        void set_input_buffers(const std::shared_ptr<std::vector<uint8_t>> &input_data);
-        std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> prepare_output_buffers();
-        void wait_and_run_async(size_t frame_idx,
-                                const std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> &output_data_and_infos);
+        void set_max_in_flight(size_t max_in_flight);
+        // Waits until every submitted job has completed. Returns false if the timeout expired first.
+        bool wait_for_in_flight(std::chrono::milliseconds timeout);
         void clear();
         
 };
@@ -0,0 +1,264 @@
+#include "async_pipeline.hpp"
+#include <iostream>
+#include <algorithm>
+#include <new>
+#include <exception>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+std::shared_ptr<uint8_t> page_aligned_alloc(size_t size, void* buff) {
+    #if defined(__unix__) || defined(__APPLE__)
+        auto addr = mmap(buff, size, PROT_WRITE | PROT_READ, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (MAP_FAILED == addr) throw std::bad_alloc();
+        return std::shared_ptr<uint8_t>(reinterpret_cast<uint8_t*>(addr), [size](void *addr) { munmap(addr, size); });
+    #elif defined(_MSC_VER)
+        auto addr = VirtualAlloc(buff, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (!addr) throw std::bad_alloc();
+        return std::shared_ptr<uint8_t>(reinterpret_cast<uint8_t*>(addr), [](void *addr){ VirtualFree(addr, 0, MEM_RELEASE); });
+    #else
+    #pragma error("Aligned alloc not supported")
+    #endif
+}
+
+struct OutputBufferPool {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<uint8_t>> storage;        // owns every pooled buffer
+    std::vector<std::vector<uint8_t *>> free_buffers;     // per output stream
+};
+
+namespace {
+
+// A pooled buffer for output stream `stream`, or null when none is free.
+std::shared_ptr<uint8_t> take_pooled_output(const std::shared_ptr<OutputBufferPool> &pool, size_t stream)
+{
+    uint8_t *data;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->free_buffers[stream].empty()) return nullptr;
+        data = pool->free_buffers[stream].back();
+        pool->free_buffers[stream].pop_back();
+    }
+    return std::shared_ptr<uint8_t>(data, [pool, stream](uint8_t *data) {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->free_buffers[stream].push_back(data);
+    });
+}
+
+} // namespace
+
+AsyncInferPipeline::AsyncInferPipeline(std::shared_ptr<InferBackend> backend, CompletionSink sink,
+                                       size_t max_in_flight, const CpuSet &consumer_cpus)
+    : backend(std::move(backend)),
+      tracker(std::make_shared<AsyncJobTracker>(std::max<size_t>(1, max_in_flight))),
+      sink(std::move(sink))
+{
+    if (consumer_cpus.empty()) return;
+
+    // Results may still wait in the consumer's queue after their slot was released, hence two sets
+    // per slot.
+    auto pool = std::make_shared<OutputBufferPool>();
+    const auto &infos = this->backend->output_infos();
+    pool->free_buffers.resize(infos.size());
+    const size_t sets = 2 * tracker->max_in_flight;
+    std::exception_ptr error;
+    std::thread toucher([&] {
+        try {
+            pin_current_thread(consumer_cpus);
+            for (size_t set = 0; set < sets; ++set) {
+                for (size_t i = 0; i < infos.size(); ++i) {
+                    auto buffer = page_aligned_alloc(infos[i].frame_size);
+                    numa_first_touch(buffer.get(), infos[i].frame_size);
+                    pool->free_buffers[i].push_back(buffer.get());
+                    pool->storage.push_back(std::move(buffer));
+                }
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+    });
+    toucher.join();
+    if (error) std::rethrow_exception(error);
+    output_pool = std::move(pool);
+}
+
+AsyncInferPipeline::~AsyncInferPipeline()
+{
+    if (!wait_for_in_flight(ASYNC_READY_TIMEOUT)) {
+        std::cerr << "AsyncInferPipeline destroyed with " << get_stats().in_flight << " jobs still in flight" << std::endl;
+    }
+}
+
+AsyncInferStats AsyncInferPipeline::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(tracker->mutex);
+    return tracker->stats;
+}
+
+void AsyncInferPipeline::set_max_in_flight(size_t max_in_flight)
+{
+    {
+        std::lock_guard<std::mutex> lock(tracker->mutex);
+        tracker->max_in_flight = std::max<size_t>(1, max_in_flight);
+    }
+    tracker->cond_slot_free.notify_all();
+}
+
+bool AsyncInferPipeline::wait_for_in_flight(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(tracker->mutex);
+    return tracker->cond_slot_free.wait_for(lock, timeout, [this] { return tracker->jobs.empty() && 0 == tracker->reserved; });
+}
+
+// Reserves one of the max_in_flight slots under the lock, so concurrent infer() calls cannot all pass
+// the check before any of them has inserted its job. submit() turns the reservation into a job;
+// every path that gives up before that calls release_slot().
+void AsyncInferPipeline::acquire_slot()
+{
+    std::unique_lock<std::mutex> lock(tracker->mutex);
+    tracker->cond_slot_free.wait(lock, [this] { return tracker->jobs.size() + tracker->reserved < tracker->max_in_flight; });
+    tracker->reserved++;
+}
+
+void AsyncInferPipeline::release_slot()
+{
+    {
+        std::lock_guard<std::mutex> lock(tracker->mutex);
+        tracker->reserved--;
+    }
+    tracker->cond_slot_free.notify_all();
+}
+
+BackendStatus AsyncInferPipeline::infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx)
+{
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> inputs(backend->input_infos().size(), input_data);
+    return infer(std::move(inputs), frame_idx);
+}
+
+BackendStatus AsyncInferPipeline::infer(std::vector<std::shared_ptr<std::vector<uint8_t>>> input_data, size_t frame_idx)
+{
+    const auto &input_infos = backend->input_infos();
+    if (input_data.size() != input_infos.size()) {
+        std::cerr << "Expected " << input_infos.size() << " input buffers, got " << input_data.size() << std::endl;
+        return BackendStatus::Failure;
+    }
+
+    acquire_slot();
+
+    InFlightJob job;
+    std::vector<BufferView> inputs;
+    inputs.reserve(input_infos.size());
+    for (size_t i = 0; i < input_infos.size(); ++i) {
+        if (!input_data[i] || input_data[i]->size() < input_infos[i].frame_size) {
+            std::cerr << "Input buffer for " << input_infos[i].name << " is smaller than its frame size" << std::endl;
+            {
+                std::lock_guard<std::mutex> lock(tracker->mutex);
+                tracker->stats.failed++;
+            }
+            release_slot();
+            return BackendStatus::Failure;
+        }
+        inputs.push_back({input_data[i]->data(), input_infos[i].frame_size});
+    }
+    job.input_guards = std::move(input_data);
+
+    return submit(std::move(job), std::move(inputs), frame_idx);
+}
+
+BackendStatus AsyncInferPipeline::submit(InFlightJob job, std::vector<BufferView> inputs, size_t frame_idx)
+{
+    std::vector<BufferView> outputs;
+    try {
+        const auto &output_infos = backend->output_infos();
+        for (size_t i = 0; i < output_infos.size(); ++i) {
+            auto output_data_holder = output_pool ? take_pooled_output(output_pool, i) : nullptr;
+            if (!output_data_holder) output_data_holder = page_aligned_alloc(output_infos[i].frame_size);
+            outputs.push_back({output_data_holder.get(), output_infos[i].frame_size});
+            job.output_guards.push_back(std::move(output_data_holder));
+        }
+    }
+    catch (...) {
+        release_slot();
+        throw;
+    }
+
+    auto status = backend->wait_for_ready(ASYNC_READY_TIMEOUT);
+    if (BackendStatus::Success != status) {
+        std::cerr << "Backend not ready for frame " << frame_idx << ", dropping it" << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(tracker->mutex);
+            if (BackendStatus::Timeout == status) {
+                tracker->stats.timeouts++;
+            } else {
+                tracker->stats.failed++;
+            }
+        }
+        release_slot();
+        return status;
+    }
+
+    size_t job_id;
+    {
+        std::lock_guard<std::mutex> lock(tracker->mutex);
+        tracker->reserved--;
+        job_id = tracker->next_job_id++;
+        tracker->jobs.emplace(job_id, std::move(job));
+        tracker->stats.submitted++;
+        tracker->stats.in_flight = tracker->jobs.size();
+        tracker->stats.peak_in_flight = std::max(tracker->stats.peak_in_flight, tracker->stats.in_flight);
+    }
+
+    auto job_tracker = tracker;
+    auto job_sink = sink;
+    auto submit_time = std::chrono::steady_clock::now();
+    status = backend->run_async(inputs, outputs,
+        [job_tracker, job_sink, job_id, frame_idx, outputs, submit_time](bool success)
+        {
+            AsyncOutputItem item;
+            item.frame_idx = frame_idx;
+            item.outputs = outputs;
+            item.success = success;
+            item.submit_time = submit_time;
+            {
+                std::lock_guard<std::mutex> lock(job_tracker->mutex);
+                auto it = job_tracker->jobs.find(job_id);
+                if (it != job_tracker->jobs.end()) {
+                    item.output_guards = std::move(it->second.output_guards);
+                }
+            }
+            // The job keeps its slot until the sink has returned, so wait_for_in_flight() and the
+            // destructor never return while a sink is still running.
+            if (job_sink) {
+                job_sink(std::move(item));
+            }
+            {
+                std::lock_guard<std::mutex> lock(job_tracker->mutex);
+                job_tracker->jobs.erase(job_id);
+                job_tracker->stats.in_flight = job_tracker->jobs.size();
+                if (success) {
+                    job_tracker->stats.completed++;
+                } else {
+                    job_tracker->stats.failed++;
+                }
+            }
+            job_tracker->cond_slot_free.notify_all();
+        });
+
+    if (BackendStatus::Success != status) {
+        std::cerr << "Failed to start async infer job for frame " << frame_idx << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(tracker->mutex);
+            tracker->jobs.erase(job_id);
+            tracker->stats.in_flight = tracker->jobs.size();
+            tracker->stats.submitted--;
+            tracker->stats.failed++;
+        }
+        tracker->cond_slot_free.notify_all();
+    }
+    return status;
+}
@@ -0,0 +1,106 @@
+#ifndef _ASYNC_PIPELINE_HPP_
+#define _ASYNC_PIPELINE_HPP_
+
+#include "infer_backend.hpp"
+#include "thread_placement.hpp"
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+
+// Counters describing the async jobs issued by an AsyncInferPipeline.
+struct AsyncInferStats {
+    size_t submitted = 0;       // jobs accepted by run_async
+    size_t completed = 0;       // completion callbacks reporting success
+    size_t failed = 0;          // run_async errors and completions reporting an error status
+    size_t timeouts = 0;        // frames dropped because the backend was not ready in time
+    size_t in_flight = 0;       // jobs submitted but not completed yet
+    size_t peak_in_flight = 0;  // highest in_flight observed
+};
+
+// Buffers owned by one async job. They are released when the job's completion callback fires
+// (the output buffers are handed over to the AsyncOutputItem given to the completion sink).
+struct InFlightJob {
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> input_guards;
+    std::vector<std::shared_ptr<uint8_t>> output_guards;
+};
+
+// State shared with the completion callbacks. Kept behind a shared_ptr so callbacks never
+// reference the (movable) pipeline owner itself.
+struct AsyncJobTracker {
+    std::mutex mutex;
+    std::condition_variable cond_slot_free;
+    std::unordered_map<size_t, InFlightJob> jobs;
+    size_t reserved = 0;        // slots taken by infer() calls that have not inserted their job yet
+    size_t next_job_id = 0;
+    size_t max_in_flight;
+    AsyncInferStats stats;
+
+    explicit AsyncJobTracker(size_t max_in_flight) : max_in_flight(max_in_flight) {}
+};
+
+// One completed job, handed to the completion sink.
+struct AsyncOutputItem {
+    size_t frame_idx;
+    std::vector<BufferView> outputs;                       // ordered like backend->output_infos()
+    std::vector<std::shared_ptr<uint8_t>> output_guards;   // owns the memory behind `outputs`
+    bool success;
+    std::chrono::steady_clock::time_point submit_time;
+};
+
+std::shared_ptr<uint8_t> page_aligned_alloc(size_t size, void *buff = nullptr);
+
+// Output buffers first-touched by a thread pinned to the consumer CPUs (see AsyncInferPipeline).
+struct OutputBufferPool;
+
+// Backend-neutral async submit/complete pipeline: binds page-aligned output buffers, bounds the
+// number of in-flight jobs (infer() blocks while the limit is reached) and forwards every completion
+// to `sink`, which usually pushes into a BoundedTSQueue.
+//
+// With `consumer_cpus` (e.g. ThreadPlacementPolicy::consumer) the output buffers come from a pool
+// that a thread pinned to those CPUs allocated and first-touched, so their pages sit on the
+// consumer's NUMA node rather than on the node of whichever thread wrote them first. A buffer goes
+// back to the pool once the last AsyncOutputItem holding it is released; when the pool is empty
+// (the consumer holds more than 2 x max_in_flight results) infer() falls back to a fresh buffer.
+class AsyncInferPipeline {
+    public:
+        static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 4;
+        static constexpr std::chrono::milliseconds ASYNC_READY_TIMEOUT{1000};
+
+        using CompletionSink = std::function<void(AsyncOutputItem &&item)>;
+
+    private:
+        std::shared_ptr<InferBackend> backend;
+        std::shared_ptr<AsyncJobTracker> tracker;
+        CompletionSink sink;
+        std::shared_ptr<OutputBufferPool> output_pool; // null without consumer_cpus
+
+        void acquire_slot();
+        void release_slot();
+        BackendStatus submit(InFlightJob job, std::vector<BufferView> inputs, size_t frame_idx);
+
+    public:
+        AsyncInferPipeline(std::shared_ptr<InferBackend> backend, CompletionSink sink,
+                           size_t max_in_flight = DEFAULT_MAX_IN_FLIGHT, const CpuSet &consumer_cpus = CpuSet());
+
+        AsyncInferPipeline(const AsyncInferPipeline&) = delete;
+        AsyncInferPipeline& operator=(const AsyncInferPipeline&) = delete;
+        ~AsyncInferPipeline(); // waits for in-flight jobs
+
+        // Binds `input_data` to every input stream and submits one job.
+        BackendStatus infer(std::shared_ptr<std::vector<uint8_t>> input_data, size_t frame_idx);
+        // Binds one buffer per input stream (ordered like backend->input_infos()).
+        BackendStatus infer(std::vector<std::shared_ptr<std::vector<uint8_t>>> input_data, size_t frame_idx);
+
+        void set_max_in_flight(size_t max_in_flight);
+        // Waits until every submitted job has completed and its sink has returned. Returns false if the
+        // timeout expired first.
+        bool wait_for_in_flight(std::chrono::milliseconds timeout);
+        AsyncInferStats get_stats() const;
+        const std::shared_ptr<InferBackend> &get_backend() const { return backend; }
+};
+
+#endif /* _ASYNC_PIPELINE_HPP_ */
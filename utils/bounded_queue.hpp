@@ -0,0 +1,184 @@
+#ifndef _BOUNDED_QUEUE_HPP_
+#define _BOUNDED_QUEUE_HPP_
+
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+template<typename T>
+class BoundedTSQueue {
+private:
+    std::queue<T> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond_not_empty;
+    std::condition_variable m_cond_not_full;
+    std::condition_variable m_cond_batch;   // pop_n waiters, woken on every push while any are waiting
+    const size_t m_max_size;
+    bool m_stopped;
+    size_t m_batch_waiters = 0;
+    size_t m_high_watermark = 0;
+
+    // Called with m_mutex held after items were added.
+    void notify_pushed(size_t count) {
+        m_high_watermark = std::max(m_high_watermark, m_queue.size());
+        if (count == 1) m_cond_not_empty.notify_one();
+        else m_cond_not_empty.notify_all();
+        if (m_batch_waiters) m_cond_batch.notify_all();
+    }
+
+    // Called with m_mutex held after items were removed.
+    void notify_popped(size_t count) {
+        if (count == 1) m_cond_not_full.notify_one();
+        else if (count > 1) m_cond_not_full.notify_all();
+    }
+
+public:
+    explicit BoundedTSQueue(size_t max_size) : m_max_size(max_size), m_stopped(false) {}
+    ~BoundedTSQueue() { stop(); reset(); }
+
+    BoundedTSQueue(const BoundedTSQueue&) = delete;
+    BoundedTSQueue& operator=(const BoundedTSQueue&) = delete;
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond_not_full.wait(lock, [this] { return m_queue.size() < m_max_size || m_stopped; });
+        if (m_stopped) return;
+
+        m_queue.push(std::move(item));
+        notify_pushed(1);
+    }
+
+    // Pushes all items in order under one lock per run of free slots, blocking while the queue is
+    // full. Returns how many were pushed: fewer than items.size() only if the queue was stopped.
+    size_t push_n(std::vector<T> items) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        size_t pushed = 0;
+        while (pushed < items.size()) {
+            m_cond_not_full.wait(lock, [this] { return m_queue.size() < m_max_size || m_stopped; });
+            if (m_stopped) break;
+
+            const size_t first = pushed;
+            while (pushed < items.size() && m_queue.size() < m_max_size) m_queue.push(std::move(items[pushed++]));
+            notify_pushed(pushed - first);
+        }
+        return pushed;
+    }
+
+    // Non-blocking push: returns false (and drops the item) when the queue is full or stopped.
+    bool try_push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stopped || m_queue.size() >= m_max_size) return false;
+
+        m_queue.push(std::move(item));
+        notify_pushed(1);
+        return true;
+    }
+
+    bool pop(T &out_item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond_not_empty.wait(lock, [this] { return !m_queue.empty() || m_stopped; });
+        if (m_stopped && m_queue.empty()) {
+            return false;
+        }
+
+        out_item = std::move(m_queue.front());
+        m_queue.pop();
+        notify_popped(1);
+        return true;
+    }
+
+    // Non-blocking pop: returns false when the queue is empty.
+    bool try_pop(T &out_item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) return false;
+
+        out_item = std::move(m_queue.front());
+        m_queue.pop();
+        notify_popped(1);
+        return true;
+    }
+
+    // Pops one item, waiting until `deadline` at most. Returns false on timeout or when the queue
+    // is stopped and empty.
+    template<typename Clock, typename Duration>
+    bool try_pop(T &out_item, const std::chrono::time_point<Clock, Duration> &deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cond_not_empty.wait_until(lock, deadline, [this] { return !m_queue.empty() || m_stopped; })) return false;
+        if (m_queue.empty()) return false;
+
+        out_item = std::move(m_queue.front());
+        m_queue.pop();
+        notify_popped(1);
+        return true;
+    }
+
+    // Batching pop: waits until `max_items` are queued (or as many as the queue can hold), the
+    // deadline passes, or the queue is stopped, whichever comes first, then appends up to
+    // `max_items` items to `out` under a single lock. Returns the number appended, possibly 0.
+    // A dynamic batcher calls it with its batch size and latency budget.
+    template<typename Clock, typename Duration>
+    size_t pop_n(std::vector<T> &out, size_t max_items, const std::chrono::time_point<Clock, Duration> &deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const size_t target = std::min(max_items, m_max_size);
+        ++m_batch_waiters;
+        m_cond_batch.wait_until(lock, deadline, [&] { return m_queue.size() >= target || m_stopped; });
+        --m_batch_waiters;
+
+        const size_t count = std::min(max_items, m_queue.size());
+        out.reserve(out.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            out.push_back(std::move(m_queue.front()));
+            m_queue.pop();
+        }
+        notify_popped(count);
+        return count;
+    }
+
+    template<typename Rep, typename Period>
+    size_t pop_n(std::vector<T> &out, size_t max_items, const std::chrono::duration<Rep, Period> &timeout) {
+        return pop_n(out, max_items, std::chrono::steady_clock::now() + timeout);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_cond_not_empty.notify_all();
+        m_cond_not_full.notify_all();
+        m_cond_batch.notify_all();
+    }
+    void reset() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Clear the queue
+            while (!m_queue.empty()) {
+                m_queue.pop();
+            }
+            // Reset the stopped flag, the statistics and conditions
+            m_stopped = false;
+            m_high_watermark = 0;
+        }
+        // Notify all waiting threads that they can continue now that the queue is "fresh"
+        m_cond_not_empty.notify_all();
+        m_cond_not_full.notify_all();
+    }
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.empty();
+    }
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+    // Largest number of items queued at once since construction or the last reset().
+    size_t high_watermark() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_high_watermark;
+    }
+};
+
+#endif /* _BOUNDED_QUEUE_HPP_ */
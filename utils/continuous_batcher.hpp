@@ -0,0 +1,232 @@
+#ifndef _CONTINUOUS_BATCHER_HPP_
+#define _CONTINUOUS_BATCHER_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+struct ContinuousBatcherConfig {
+    size_t token_budget = 4096;     // tokens a single step may process (sum over the running batch)
+    size_t max_batch_size = 64;     // sequences in the running batch
+};
+
+struct ContinuousBatcherStats {
+    size_t requests = 0;            // sequences completed
+    size_t steps = 0;               // step function calls
+    double mean_batch_size = 0;     // sequences per step
+    double mean_budget_use = 0;     // step tokens / token_budget
+    double queue_delay_mean_ms = 0; // submit -> admitted into the running batch
+    double queue_delay_p50_ms = 0;
+    double queue_delay_p99_ms = 0;
+    double compute_mean_ms = 0;     // admitted -> finished (time spent in steps)
+    double compute_p50_ms = 0;
+    double compute_p99_ms = 0;
+};
+
+// Iteration-level (continuous) batching: a worker thread keeps a running batch and calls the step
+// function on it repeatedly. Before every step, queued sequences are admitted in FIFO order while
+// the step stays within the token budget, so new work joins as soon as earlier sequences finish
+// instead of waiting for a whole static batch to drain.
+//
+// The step function sets `finished` (and `result`) on the sequences it completed; unfinished ones
+// stay in the batch and may lower `tokens` to their next-step cost (e.g. 1 per generated token).
+// A sequence larger than the whole budget is admitted alone.
+template <typename Request, typename Result>
+class ContinuousBatcher {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Sequence {
+            Request request;
+            size_t tokens = 0;          // cost of this sequence in the next step
+            Result result{};
+            bool finished = false;
+
+            Clock::time_point submit_time;
+            Clock::time_point admit_time;
+            std::promise<Result> promise;
+        };
+
+        using StepFn = std::function<void(std::vector<Sequence *> &batch)>;
+
+    private:
+        StepFn step;
+        ContinuousBatcherConfig config;
+
+        std::mutex mutex;
+        std::condition_variable cond_work;
+        std::deque<std::unique_ptr<Sequence>> pending;
+        bool stopped = false;
+
+        // Owned by the worker thread; stats are copied out under `mutex`.
+        std::vector<std::unique_ptr<Sequence>> running;
+        std::vector<double> queue_delays_ms;
+        std::vector<double> compute_ms;
+        size_t steps = 0;
+        size_t batch_size_sum = 0;
+        double budget_use_sum = 0;
+        std::thread worker;
+
+        static double percentile(std::vector<double> values, double p)
+        {
+            if (values.empty()) return 0;
+            std::sort(values.begin(), values.end());
+            size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+            return values[std::min(idx, values.size() - 1)];
+        }
+
+        static double elapsed_ms(Clock::time_point from, Clock::time_point to)
+        {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        }
+
+        // Called with `mutex` held.
+        void admit(size_t &step_tokens)
+        {
+            auto now = Clock::now();
+            while (!pending.empty() && running.size() < config.max_batch_size) {
+                const size_t tokens = pending.front()->tokens;
+                if (!running.empty() && step_tokens + tokens > config.token_budget) break;
+                pending.front()->admit_time = now;
+                queue_delays_ms.push_back(elapsed_ms(pending.front()->submit_time, now));
+                step_tokens += tokens;
+                running.push_back(std::move(pending.front()));
+                pending.pop_front();
+            }
+        }
+
+        void worker_loop()
+        {
+            std::vector<Sequence *> batch;
+            while (true) {
+                size_t step_tokens = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond_work.wait(lock, [this] { return stopped || !pending.empty() || !running.empty(); });
+                    if (stopped && pending.empty() && running.empty()) return;
+                    for (const auto &sequence : running) step_tokens += sequence->tokens;
+                    admit(step_tokens);
+                }
+
+                batch.clear();
+                for (auto &sequence : running) batch.push_back(sequence.get());
+                try {
+                    step(batch);
+                }
+                catch (...) {
+                    // A failed step fails every sequence in it.
+                    for (auto &sequence : running) {
+                        sequence->promise.set_exception(std::current_exception());
+                    }
+                    running.clear();
+                    continue;
+                }
+
+                auto now = Clock::now();
+                std::lock_guard<std::mutex> lock(mutex);
+                steps++;
+                batch_size_sum += batch.size();
+                budget_use_sum += static_cast<double>(step_tokens) / std::max<size_t>(1, config.token_budget);
+                auto done = std::stable_partition(running.begin(), running.end(),
+                                                  [](const std::unique_ptr<Sequence> &s) { return !s->finished; });
+                for (auto it = done; it != running.end(); ++it) {
+                    compute_ms.push_back(elapsed_ms((*it)->admit_time, now));
+                    (*it)->promise.set_value(std::move((*it)->result));
+                }
+                running.erase(done, running.end());
+            }
+        }
+
+    public:
+        ContinuousBatcher(StepFn step, ContinuousBatcherConfig config = ContinuousBatcherConfig())
+            : step(std::move(step)), config(config)
+        {
+            this->config.token_budget = std::max<size_t>(1, this->config.token_budget);
+            this->config.max_batch_size = std::max<size_t>(1, this->config.max_batch_size);
+            worker = std::thread(&ContinuousBatcher::worker_loop, this);
+        }
+
+        ContinuousBatcher(const ContinuousBatcher&) = delete;
+        ContinuousBatcher& operator=(const ContinuousBatcher&) = delete;
+
+        // Finishes every submitted sequence before returning.
+        ~ContinuousBatcher()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+            }
+            cond_work.notify_all();
+            worker.join();
+        }
+
+        // `tokens` is the sequence's cost in its first step (e.g. its real prompt length).
+        std::future<Result> submit(Request request, size_t tokens)
+        {
+            auto sequence = std::make_unique<Sequence>();
+            sequence->request = std::move(request);
+            sequence->tokens = tokens;
+            sequence->submit_time = Clock::now();
+            std::future<Result> future = sequence->promise.get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopped) throw std::runtime_error("ContinuousBatcher is stopped");
+                pending.push_back(std::move(sequence));
+            }
+            cond_work.notify_one();
+            return future;
+        }
+
+        ContinuousBatcherStats get_stats()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ContinuousBatcherStats stats;
+            stats.requests = compute_ms.size();
+            stats.steps = steps;
+            if (steps) {
+                stats.mean_batch_size = static_cast<double>(batch_size_sum) / steps;
+                stats.mean_budget_use = budget_use_sum / steps;
+            }
+            if (!queue_delays_ms.empty()) {
+                double sum = 0;
+                for (double v : queue_delays_ms) sum += v;
+                stats.queue_delay_mean_ms = sum / queue_delays_ms.size();
+                stats.queue_delay_p50_ms = percentile(queue_delays_ms, 50);
+                stats.queue_delay_p99_ms = percentile(queue_delays_ms, 99);
+            }
+            if (!compute_ms.empty()) {
+                double sum = 0;
+                for (double v : compute_ms) sum += v;
+                stats.compute_mean_ms = sum / compute_ms.size();
+                stats.compute_p50_ms = percentile(compute_ms, 50);
+                stats.compute_p99_ms = percentile(compute_ms, 99);
+            }
+            return stats;
+        }
+};
+
+inline void print_continuous_batcher_stats(const ContinuousBatcherStats &stats)
+{
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Continuous batching" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Sequences:        " << stats.requests << " in " << stats.steps << " steps, mean batch "
+              << stats.mean_batch_size << ", token budget use " << stats.mean_budget_use * 100 << "%" << std::endl;
+    std::cout << "-I- Queue delay:      mean " << stats.queue_delay_mean_ms << " ms, p50 " << stats.queue_delay_p50_ms
+              << " ms, p99 " << stats.queue_delay_p99_ms << " ms" << std::endl;
+    std::cout << "-I- Compute:          mean " << stats.compute_mean_ms << " ms, p50 " << stats.compute_p50_ms
+              << " ms, p99 " << stats.compute_p99_ms << " ms" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+#endif /* _CONTINUOUS_BATCHER_HPP_ */
@@ -0,0 +1,117 @@
+#include "cpu_backend.hpp"
+#include <algorithm>
+#include <cstring>
+
+CpuInferBackend::CpuInferBackend(CpuBackendConfig config)
+    : config(std::move(config))
+{
+    this->config.worker_threads = std::max<size_t>(1, this->config.worker_threads);
+    this->config.queue_depth = std::max(this->config.queue_depth, this->config.worker_threads);
+    std::vector<CpuSet> engine_cpus = this->config.worker_cpus.split(this->config.worker_threads);
+    for (size_t i = 0; i < this->config.worker_threads; ++i) {
+        CpuSet cpus = engine_cpus[i].empty() ? this->config.worker_cpus : engine_cpus[i];
+        workers.emplace_back(&CpuInferBackend::worker_loop, this, cpus);
+    }
+}
+
+CpuInferBackend::~CpuInferBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    cond_job_ready.notify_all();
+    cond_slot_free.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    // Jobs never started still owe their completion.
+    for (auto &job : jobs) {
+        job.on_done(false);
+    }
+}
+
+BackendStatus CpuInferBackend::wait_for_ready(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    bool ready = cond_slot_free.wait_for(lock, timeout, [this] {
+        return queued_or_running < config.queue_depth || stopped;
+    });
+    if (stopped) return BackendStatus::Failure;
+    return ready ? BackendStatus::Success : BackendStatus::Timeout;
+}
+
+BackendStatus CpuInferBackend::run_async(const std::vector<BufferView> &inputs,
+                                         const std::vector<BufferView> &outputs,
+                                         CompletionCallback on_done)
+{
+    if (inputs.size() != config.inputs.size() || outputs.size() != config.outputs.size()) {
+        return BackendStatus::Failure;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopped) return BackendStatus::Failure;
+        jobs.push_back({inputs, outputs, std::move(on_done)});
+        queued_or_running++;
+    }
+    cond_job_ready.notify_one();
+    return BackendStatus::Success;
+}
+
+void CpuInferBackend::worker_loop(CpuSet cpus)
+{
+    pin_current_thread(cpus);
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond_job_ready.wait(lock, [this] { return !jobs.empty() || stopped; });
+            if (stopped) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        run_kernel(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued_or_running--;
+        }
+        cond_slot_free.notify_one();
+        job.on_done(true);
+    }
+}
+
+void CpuInferBackend::run_kernel(const Job &job)
+{
+    auto deadline = std::chrono::steady_clock::now() + config.compute_time;
+
+    // Touch every input byte and every output byte once, as a device DMA would.
+    uint64_t checksum = 0;
+    for (const auto &input : job.inputs) {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= input.size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, input.data + i, sizeof(word));
+            checksum ^= word;
+        }
+        for (; i < input.size; ++i) {
+            checksum ^= input.data[i];
+        }
+    }
+    for (const auto &output : job.outputs) {
+        const size_t floats = output.size / sizeof(float);
+        float *dst = reinterpret_cast<float *>(output.data);
+        for (size_t i = 0; i < floats; ++i) {
+            dst[i] = static_cast<float>((checksum + i) & 0xff) / 255.0f;
+        }
+        std::memset(output.data + floats * sizeof(float), 0, output.size - floats * sizeof(float));
+    }
+
+    if (config.busy_compute) {
+        while (std::chrono::steady_clock::now() < deadline) {
+        }
+    } else {
+        std::this_thread::sleep_until(deadline);
+    }
+}
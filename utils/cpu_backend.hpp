@@ -0,0 +1,61 @@
+#ifndef _CPU_BACKEND_HPP_
+#define _CPU_BACKEND_HPP_
+
+#include "infer_backend.hpp"
+#include "thread_placement.hpp"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+struct CpuBackendConfig {
+    std::vector<TensorInfo> inputs{{"input", 640 * 640 * 3}};
+    std::vector<TensorInfo> outputs{{"output", 80 * (1 + 100 * 5) * sizeof(float)}};
+    size_t worker_threads = 1;                       // emulated device engines running jobs concurrently
+    size_t queue_depth = 8;                          // jobs accepted before wait_for_ready() blocks
+    std::chrono::microseconds compute_time{5000};    // minimum time a job occupies its engine
+    bool busy_compute = false;                       // spin instead of sleep (CPU-bound model vs offloaded device)
+    CpuSet worker_cpus;                              // pins the engines (split evenly across them); empty = unpinned
+};
+
+// Reference InferBackend that runs a synthetic kernel on CPU threads, so the async pipeline
+// (buffers, bindings, backpressure, completion queue) can be profiled without an accelerator.
+//
+// Every job reads all input bytes, writes every output byte and then occupies its worker for the
+// rest of `compute_time`, so memory traffic and queueing behave like a real device.
+class CpuInferBackend : public InferBackend {
+    private:
+        struct Job {
+            std::vector<BufferView> inputs;
+            std::vector<BufferView> outputs;
+            CompletionCallback on_done;
+        };
+
+        CpuBackendConfig config;
+        std::deque<Job> jobs;
+        std::mutex mutex;
+        std::condition_variable cond_job_ready;
+        std::condition_variable cond_slot_free;
+        size_t queued_or_running = 0;
+        bool stopped = false;
+        std::vector<std::thread> workers;
+
+        void worker_loop(CpuSet cpus);
+        void run_kernel(const Job &job);
+
+    public:
+        explicit CpuInferBackend(CpuBackendConfig config = CpuBackendConfig());
+        ~CpuInferBackend() override;
+
+        CpuInferBackend(const CpuInferBackend&) = delete;
+        CpuInferBackend& operator=(const CpuInferBackend&) = delete;
+
+        const std::vector<TensorInfo> &input_infos() const override { return config.inputs; }
+        const std::vector<TensorInfo> &output_infos() const override { return config.outputs; }
+        BackendStatus wait_for_ready(std::chrono::milliseconds timeout) override;
+        BackendStatus run_async(const std::vector<BufferView> &inputs,
+                                const std::vector<BufferView> &outputs,
+                                CompletionCallback on_done) override;
+};
+
+#endif /* _CPU_BACKEND_HPP_ */
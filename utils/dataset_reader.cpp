@@ -0,0 +1,263 @@
+#include "dataset_reader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string normalize(const std::string &path)
+{
+    std::string out = std::filesystem::path(path).lexically_normal().generic_string();
+    while (0 == out.compare(0, 2, "./")) out.erase(0, 2);
+    return out;
+}
+
+std::string file_name(const std::string &normalized)
+{
+    const size_t slash = normalized.rfind('/');
+    return std::string::npos == slash ? normalized : normalized.substr(slash + 1);
+}
+
+} // namespace
+
+FileBytes read_file_bytes(const std::string &path)
+{
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return nullptr;
+    auto bytes = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(bytes->data()), static_cast<std::streamsize>(bytes->size()))) return nullptr;
+    return bytes;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+#if defined(__linux__)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    struct stat st;
+    if (0 != ::fstat(fd, &st)) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto bytes = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(st.st_size));
+    size_t done = 0;
+    while (done < bytes->size()) {
+        const ssize_t n = ::read(fd, bytes->data() + done, bytes->size() - done);
+        if (n < 0 && EINTR == errno) continue;
+        if (n < 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        if (0 == n) break;
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    bytes->resize(done);
+    return bytes;
+#endif
+}
+
+void hint_file(const std::string &path)
+{
+#if defined(__linux__)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+#elif defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (0 == ::fstat(fd, &st) && st.st_size > 0) {
+        struct radvisory advice;
+        advice.ra_offset = 0;
+        advice.ra_count = static_cast<int>(std::min<off_t>(st.st_size, INT32_MAX));
+        ::fcntl(fd, F_RDADVISE, &advice);
+    }
+    ::close(fd);
+#else
+    (void)path;
+#endif
+}
+
+std::vector<std::string> plan_dataset_order(const std::string &path)
+{
+    std::vector<std::string> plan;
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+            if (entry.is_regular_file(ec)) {
+                plan.push_back(entry.path().lexically_relative(path).generic_string());
+            }
+        }
+        std::sort(plan.begin(), plan.end());
+        return plan;
+    }
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream tokens(line);
+        std::string name;
+        if (tokens >> name && '#' != name[0]) plan.push_back(name);
+    }
+    return plan;
+}
+
+DatasetReadahead::DatasetReadahead(std::vector<std::string> plan, const ReadaheadConfig &config)
+    : plan(std::move(plan)), config(config)
+{
+    for (auto &entry : this->plan) entry = normalize(entry);
+    for (size_t i = 0; i < this->plan.size(); ++i) by_name[file_name(this->plan[i])].push_back(i);
+    for (size_t i = 0; i < std::max<size_t>(1, config.threads); ++i) workers.emplace_back(&DatasetReadahead::worker_loop, this);
+}
+
+DatasetReadahead::~DatasetReadahead()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cond_work.notify_all();
+    cond_ready.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+// Finds the plan entry `path` ends with, preferring the first one at or after the cursor when a
+// file name occurs more than once, and learns the directory the entries are relative to.
+bool DatasetReadahead::locate(const std::string &path, size_t &index)
+{
+    auto it = by_name.find(file_name(path));
+    if (by_name.end() == it) return false;
+
+    bool found = false;
+    for (size_t candidate : it->second) {
+        const std::string &entry = plan[candidate];
+        if (path.size() < entry.size() || 0 != path.compare(path.size() - entry.size(), entry.size(), entry)) continue;
+        if (path.size() > entry.size() && '/' != path[path.size() - entry.size() - 1]) continue;
+        if (!found || (index < cursor && candidate >= cursor)) {
+            index = candidate;
+            found = true;
+        }
+    }
+    if (found) base = path.substr(0, path.size() - plan[index].size());
+    return found;
+}
+
+// Keeps slots for [index - depth, index + depth] (a little history, so concurrent preprocess calls
+// slightly out of order still hit) and queues reads and hints for the files after `index`.
+void DatasetReadahead::schedule(size_t index)
+{
+    const size_t depth = config.depth;
+    for (auto it = slots.begin(); it != slots.end();) {
+        if (it->first + depth < index || it->first > index + depth) it = slots.erase(it);
+        else ++it;
+    }
+
+    const size_t read_end = std::min(plan.size(), index + depth + 1);
+    for (size_t i = index + 1; i < read_end; ++i) {
+        if (slots.count(i)) continue;
+        slots[i] = Slot();
+        reads.push_back({i, base + plan[i]});
+    }
+
+    const size_t hint_end = std::min(plan.size(), read_end + config.hint_depth);
+    for (size_t i = std::max(hinted_until, read_end); i < hint_end; ++i) hints.push_back(base + plan[i]);
+    hinted_until = std::max(hinted_until, hint_end);
+    cond_work.notify_all();
+}
+
+void DatasetReadahead::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cond_work.wait(lock, [&] { return stopping || !reads.empty() || !hints.empty(); });
+        if (stopping) return;
+
+        if (!reads.empty()) {
+            Job job = std::move(reads.front());
+            reads.pop_front();
+            auto it = slots.find(job.index);
+            if (slots.end() == it || SlotState::Queued != it->second.state) continue; // dropped or taken by the caller
+            it->second.state = SlotState::Reading;
+
+            lock.unlock();
+            FileBytes bytes = read_file_bytes(job.path);
+            lock.lock();
+
+            it = slots.find(job.index);
+            if (slots.end() != it && SlotState::Reading == it->second.state) {
+                it->second.state = SlotState::Ready;
+                it->second.bytes = bytes;
+            }
+            if (bytes) counters.bytes += bytes->size();
+            cond_ready.notify_all();
+        } else {
+            std::string path = std::move(hints.front());
+            hints.pop_front();
+            lock.unlock();
+            hint_file(path);
+            lock.lock();
+        }
+    }
+}
+
+FileBytes DatasetReadahead::read(const std::string &path)
+{
+    const std::string normalized = normalize(path);
+    std::unique_lock<std::mutex> lock(mutex);
+
+    size_t index = 0;
+    if (!locate(normalized, index)) {
+        counters.misses++;
+        lock.unlock();
+        return read_file_bytes(path);
+    }
+    if (index + config.depth < cursor) hinted_until = 0; // the order restarted (e.g. another pass)
+    cursor = index;
+    schedule(index);
+
+    auto it = slots.find(index);
+    if (slots.end() != it && SlotState::Reading == it->second.state) {
+        counters.waits++;
+        const auto start = std::chrono::steady_clock::now();
+        cond_ready.wait(lock, [&] {
+            auto slot = slots.find(index);
+            return stopping || slots.end() == slot || SlotState::Ready == slot->second.state;
+        });
+        counters.wait_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        it = slots.find(index);
+        if (slots.end() != it && SlotState::Ready == it->second.state) {
+            FileBytes bytes = std::move(it->second.bytes);
+            slots.erase(it);
+            return bytes;
+        }
+    } else if (slots.end() != it && SlotState::Ready == it->second.state) {
+        counters.hits++;
+        FileBytes bytes = std::move(it->second.bytes);
+        slots.erase(it);
+        return bytes;
+    }
+
+    // Not read ahead, or still queued behind other reads: read it here rather than wait.
+    if (slots.end() != it) slots.erase(it);
+    counters.misses++;
+    lock.unlock();
+    return read_file_bytes(path);
+}
+
+ReadaheadStats DatasetReadahead::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
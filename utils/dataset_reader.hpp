@@ -0,0 +1,99 @@
+#ifndef _DATASET_READER_HPP_
+#define _DATASET_READER_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Encoded file contents, shared so a buffer can be handed to a decoder without copying.
+using FileBytes = std::shared_ptr<const std::vector<uint8_t>>;
+
+// Reads a whole file, hinting sequential access to the kernel. Returns nullptr if it cannot be read.
+FileBytes read_file_bytes(const std::string &path);
+
+// Asks the kernel to start reading the file into the page cache (posix_fadvise WILLNEED on Linux,
+// F_RDADVISE on macOS) and returns immediately. No-op elsewhere.
+void hint_file(const std::string &path);
+
+// Access order of a dataset: the first whitespace-separated token of every non-empty line of a list
+// file such as labels.txt or val.txt ("ILSVRC2012_val_00000001.JPEG 65" -> the file name), or the
+// regular files of a directory in sorted order when `path` is a directory. Entries are relative
+// paths; where they live is learned from the first path the submitter asks for.
+std::vector<std::string> plan_dataset_order(const std::string &path);
+
+struct ReadaheadConfig {
+    size_t depth = 16;          // files read into memory ahead of the one being requested
+    size_t hint_depth = 64;     // files after those only hinted to the kernel
+    size_t threads = 4;         // background readers; several requests in flight hide network latency
+};
+
+struct ReadaheadStats {
+    size_t hits = 0;            // buffer was ready when requested
+    size_t waits = 0;           // read was in flight; the caller waited for it
+    size_t misses = 0;          // not read ahead (unplanned path, or a jump in the order); read synchronously
+    uint64_t bytes = 0;         // bytes read by the background readers
+    double wait_ms = 0;         // total time callers spent waiting for in-flight reads
+};
+
+// Reads dataset files ahead of the submitter. preprocessVisionData calls read(imagePath) instead of
+// opening the file itself; each call moves the window to that file's position in the plan, so the
+// next `depth` files are read on background threads and the `hint_depth` after them are prefetched
+// by the kernel while the current image is decoded and inferred. Paths outside the plan are read
+// synchronously. Thread-safe.
+class DatasetReadahead
+{
+private:
+    enum class SlotState { Queued, Reading, Ready };
+
+    struct Slot {
+        SlotState state = SlotState::Queued;
+        FileBytes bytes;
+    };
+
+    struct Job {
+        size_t index;
+        std::string path;
+    };
+
+    std::vector<std::string> plan;
+    const ReadaheadConfig config;
+    std::unordered_map<std::string, std::vector<size_t>> by_name; // file name -> plan indices
+
+    mutable std::mutex mutex;
+    std::condition_variable cond_work;
+    std::condition_variable cond_ready;
+    std::string base;                   // prefix that turns a plan entry into a path
+    size_t cursor = 0;
+    size_t hinted_until = 0;            // plan indices below this were already hinted
+    std::map<size_t, Slot> slots;       // read-ahead window
+    std::deque<Job> reads;
+    std::deque<std::string> hints;
+    ReadaheadStats counters;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    bool locate(const std::string &path, size_t &index);
+    void schedule(size_t index);
+    void worker_loop();
+
+public:
+    explicit DatasetReadahead(std::vector<std::string> plan, const ReadaheadConfig &config = ReadaheadConfig());
+    ~DatasetReadahead();
+
+    DatasetReadahead(const DatasetReadahead &) = delete;
+    DatasetReadahead &operator=(const DatasetReadahead &) = delete;
+
+    // Contents of `path`, or nullptr if it cannot be read.
+    FileBytes read(const std::string &path);
+
+    ReadaheadStats stats() const;
+};
+
+#endif /* _DATASET_READER_HPP_ */
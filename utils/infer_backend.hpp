@@ -0,0 +1,53 @@
+#ifndef _INFER_BACKEND_HPP_
+#define _INFER_BACKEND_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+// Backend-neutral description of one input or output stream.
+struct TensorInfo {
+    std::string name;
+    size_t frame_size;  // bytes per frame
+};
+
+// Non-owning view of a buffer bound to a stream for one job.
+struct BufferView {
+    uint8_t *data;
+    size_t size;
+};
+
+enum class BackendStatus {
+    Success,
+    Timeout,
+    Failure,
+};
+
+// Device/runtime side of the async pipeline. AsyncInferPipeline owns buffers, in-flight tracking and
+// the completion queue; a backend only has to bind buffers and start jobs.
+//
+// Implementations: HailoInferBackend (async_inference.hpp, needs HailoRT) and CpuInferBackend
+// (cpu_backend.hpp, runs anywhere).
+class InferBackend {
+public:
+    using CompletionCallback = std::function<void(bool success)>;
+
+    virtual ~InferBackend() = default;
+
+    virtual const std::vector<TensorInfo> &input_infos() const = 0;
+    virtual const std::vector<TensorInfo> &output_infos() const = 0;
+
+    // Blocks until the backend can accept another job.
+    virtual BackendStatus wait_for_ready(std::chrono::milliseconds timeout) = 0;
+
+    // Starts one job. Buffers are ordered like input_infos()/output_infos() and must stay valid until
+    // `on_done` runs. `on_done` is called exactly once if (and only if) Success is returned.
+    virtual BackendStatus run_async(const std::vector<BufferView> &inputs,
+                                    const std::vector<BufferView> &outputs,
+                                    CompletionCallback on_done) = 0;
+};
+
+#endif /* _INFER_BACKEND_HPP_ */
@@ -0,0 +1,291 @@
+#ifndef _LOAD_SCENARIOS_HPP_
+#define _LOAD_SCENARIOS_HPP_
+
+#include "ai_bmt_interface.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// MLPerf-style load scenarios:
+//   SingleStream  one query at a time, the next issued when the previous returns   metric: p90 latency
+//   MultiStream   groups of `samples_per_query` queries, issued back to back         metric: p99 group latency
+//   Server        Poisson arrivals at `target_qps`; latency counts from arrival     metric: achieved QPS, valid if p99 <= latency_bound
+//   Offline       every query at once, in calls of `offline_batch_size`, repeated    metric: samples/s
+//                 until min_duration has passed
+enum class LoadScenario {
+    SingleStream,
+    MultiStream,
+    Server,
+    Offline,
+};
+
+inline const char *load_scenario_name(LoadScenario scenario)
+{
+    switch (scenario) {
+        case LoadScenario::SingleStream: return "SingleStream";
+        case LoadScenario::MultiStream: return "MultiStream";
+        case LoadScenario::Server: return "Server";
+        case LoadScenario::Offline: return "Offline";
+    }
+    return "Unknown";
+}
+
+inline LoadScenario parse_load_scenario(const std::string &name)
+{
+    for (LoadScenario s : {LoadScenario::SingleStream, LoadScenario::MultiStream, LoadScenario::Server, LoadScenario::Offline}) {
+        if (name == load_scenario_name(s)) return s;
+    }
+    throw std::invalid_argument("Unknown load scenario: " + name);
+}
+
+struct LoadScenarioConfig {
+    LoadScenario scenario = LoadScenario::SingleStream;
+    size_t min_queries = 1024;                              // queries (MultiStream: groups) to issue at least
+    std::chrono::milliseconds min_duration{10000};          // and keep issuing until this much time has passed
+    size_t samples_per_query = 8;                           // MultiStream group size
+    double target_qps = 100;                                // Server arrival rate
+    std::chrono::milliseconds latency_bound{100};           // Server p99 bound
+    size_t max_outstanding = 16;                            // Server: queries in flight (issuing threads)
+    size_t offline_batch_size = 0;                          // Offline: queries per call, 0 = all in one call
+    uint64_t seed = 42;                                     // Server arrival schedule
+};
+
+struct LoadScenarioResult {
+    LoadScenario scenario = LoadScenario::SingleStream;
+    size_t queries = 0;                 // issued queries (MultiStream: groups)
+    size_t samples = 0;                 // samples inferred
+    size_t failed = 0;                  // calls that threw or returned fewer results than samples
+    double duration_s = 0;
+    double samples_per_second = 0;
+    double latency_mean_ms = 0;         // per query (MultiStream: per group)
+    double latency_p50_ms = 0;
+    double latency_p90_ms = 0;
+    double latency_p99_ms = 0;
+    double latency_max_ms = 0;
+    std::string metric_name;
+    double metric = 0;
+    bool valid = true;                  // Server: p99 within the bound and the target rate kept up with
+};
+
+// Drives any AI_BMT_Interface with pre-processed samples under one of the scenarios above.
+// Samples are reused round-robin when a scenario needs more queries than there are samples.
+class LoadScenarioRunner
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::shared_ptr<AI_BMT_Interface> interface;
+    std::vector<VariantType> samples;
+    bool vision;
+
+    static double percentile(std::vector<double> sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+
+    // Runs one call and returns false if it failed or returned too few results.
+    bool infer(const std::vector<VariantType> &batch)
+    {
+        try {
+            size_t results = vision ? interface->inferVision(batch).size() : interface->inferLLM(batch).size();
+            return results == batch.size();
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Load scenario: inference failed: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<VariantType> make_batch(size_t first, size_t count) const
+    {
+        std::vector<VariantType> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; ++i) batch.push_back(samples[(first + i) % samples.size()]);
+        return batch;
+    }
+
+    // Back-to-back queries of `group` samples until both minimums are met.
+    void run_sequential(const LoadScenarioConfig &config, size_t group, LoadScenarioResult &result, std::vector<double> &latencies)
+    {
+        auto start = Clock::now();
+        size_t cursor = 0;
+        while (result.queries < config.min_queries || Clock::now() - start < config.min_duration) {
+            std::vector<VariantType> batch = make_batch(cursor, group);
+            cursor += group;
+            auto issue = Clock::now();
+            if (!infer(batch)) result.failed++;
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - issue).count());
+            result.queries++;
+            result.samples += group;
+        }
+    }
+
+    void run_server(const LoadScenarioConfig &config, LoadScenarioResult &result, std::vector<double> &latencies)
+    {
+        if (config.target_qps <= 0) throw std::invalid_argument("Server scenario needs target_qps > 0");
+        const size_t count = std::max(config.min_queries,
+                                      static_cast<size_t>(config.target_qps * config.min_duration.count() / 1000.0));
+
+        // Poisson process: exponential inter-arrival times at the target rate.
+        std::mt19937_64 rng(config.seed);
+        std::exponential_distribution<double> gap(config.target_qps);
+        std::vector<Clock::duration> arrivals(count);
+        double t = 0;
+        for (size_t i = 0; i < count; ++i) {
+            arrivals[i] = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(t));
+            t += gap(rng);
+        }
+
+        latencies.assign(count, 0);
+        std::vector<char> ok(count, 0);
+        std::atomic<size_t> next{0};
+        const auto start = Clock::now();
+        auto issuer = [&] {
+            for (size_t i = next++; i < count; i = next++) {
+                const auto arrival = start + arrivals[i];
+                std::this_thread::sleep_until(arrival);
+                ok[i] = infer(make_batch(i, 1));
+                latencies[i] = std::chrono::duration<double, std::milli>(Clock::now() - arrival).count();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < std::max<size_t>(1, config.max_outstanding); ++i) threads.emplace_back(issuer);
+        for (auto &thread : threads) thread.join();
+
+        result.queries = count;
+        result.samples = count;
+        result.failed = static_cast<size_t>(std::count(ok.begin(), ok.end(), 0));
+    }
+
+    // Passes over every query, repeated until both minimums are met (MLPerf repeats the Offline
+    // query the same way when one pass is shorter than the minimum duration).
+    void run_offline(const LoadScenarioConfig &config, LoadScenarioResult &result, std::vector<double> &latencies)
+    {
+        const size_t count = std::max(config.min_queries, samples.size());
+        const size_t batch_size = config.offline_batch_size ? config.offline_batch_size : count;
+        auto start = Clock::now();
+        size_t cursor = 0;
+        do {
+            for (size_t first = 0; first < count; first += batch_size) {
+                const size_t n = std::min(batch_size, count - first);
+                std::vector<VariantType> batch = make_batch(cursor + first, n);
+                auto issue = Clock::now();
+                if (!infer(batch)) result.failed++;
+                latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - issue).count());
+            }
+            cursor += count;
+            result.queries += count;
+            result.samples += count;
+        } while (Clock::now() - start < config.min_duration);
+    }
+
+public:
+    // `samples` are outputs of the interface's preprocessVisionData/preprocessLLMData, so they must be
+    // owning values (vectors, LLMPreprocessedInput): each is copied into every query that uses it.
+    LoadScenarioRunner(std::shared_ptr<AI_BMT_Interface> interface, std::vector<VariantType> samples)
+        : interface(std::move(interface)), samples(std::move(samples))
+    {
+        if (this->samples.empty()) throw std::invalid_argument("LoadScenarioRunner needs at least one sample");
+        vision = this->interface->getInterfaceType() <= InterfaceType::SemanticSegmentation_CustomDataset;
+    }
+
+    LoadScenarioResult run(const LoadScenarioConfig &config)
+    {
+        LoadScenarioResult result;
+        result.scenario = config.scenario;
+        std::vector<double> latencies;
+
+        auto start = Clock::now();
+        switch (config.scenario) {
+            case LoadScenario::SingleStream: run_sequential(config, 1, result, latencies); break;
+            case LoadScenario::MultiStream: run_sequential(config, std::max<size_t>(1, config.samples_per_query), result, latencies); break;
+            case LoadScenario::Server: run_server(config, result, latencies); break;
+            case LoadScenario::Offline: run_offline(config, result, latencies); break;
+        }
+        result.duration_s = std::chrono::duration<double>(Clock::now() - start).count();
+        result.samples_per_second = result.duration_s > 0 ? result.samples / result.duration_s : 0;
+
+        std::sort(latencies.begin(), latencies.end());
+        if (!latencies.empty()) {
+            double sum = 0;
+            for (double v : latencies) sum += v;
+            result.latency_mean_ms = sum / latencies.size();
+            result.latency_p50_ms = percentile(latencies, 50);
+            result.latency_p90_ms = percentile(latencies, 90);
+            result.latency_p99_ms = percentile(latencies, 99);
+            result.latency_max_ms = latencies.back();
+        }
+
+        switch (config.scenario) {
+            case LoadScenario::SingleStream:
+                result.metric_name = "p90_latency_ms";
+                result.metric = result.latency_p90_ms;
+                break;
+            case LoadScenario::MultiStream:
+                result.metric_name = "p99_latency_ms";
+                result.metric = result.latency_p99_ms;
+                break;
+            case LoadScenario::Server: {
+                result.metric_name = "server_qps";
+                result.metric = result.samples_per_second;
+                // Issuing must keep up with the schedule: the run may overrun it by at most 10%.
+                const double scheduled_s = result.queries / config.target_qps;
+                result.valid = result.latency_p99_ms <= config.latency_bound.count() && result.duration_s <= scheduled_s * 1.1 + 0.1;
+                break;
+            }
+            case LoadScenario::Offline:
+                result.metric_name = "samples_per_second";
+                result.metric = result.samples_per_second;
+                break;
+        }
+        result.valid = result.valid && 0 == result.failed;
+        return result;
+    }
+};
+
+inline std::string load_scenario_result_to_json(const LoadScenarioResult &result)
+{
+    std::ostringstream out;
+    out << "{\"scenario\": \"" << load_scenario_name(result.scenario) << "\""
+        << ", \"metric_name\": \"" << result.metric_name << "\""
+        << ", \"metric\": " << result.metric
+        << ", \"valid\": " << (result.valid ? "true" : "false")
+        << ", \"queries\": " << result.queries
+        << ", \"samples\": " << result.samples
+        << ", \"failed\": " << result.failed
+        << ", \"duration_s\": " << result.duration_s
+        << ", \"samples_per_second\": " << result.samples_per_second
+        << ", \"latency_mean_ms\": " << result.latency_mean_ms
+        << ", \"latency_p50_ms\": " << result.latency_p50_ms
+        << ", \"latency_p90_ms\": " << result.latency_p90_ms
+        << ", \"latency_p99_ms\": " << result.latency_p99_ms
+        << ", \"latency_max_ms\": " << result.latency_max_ms << "}";
+    return out.str();
+}
+
+inline void print_load_scenario_result(const LoadScenarioResult &result)
+{
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Scenario: " << load_scenario_name(result.scenario) << (result.valid ? "" : " (INVALID)") << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Result:           " << result.metric_name << " = " << result.metric << std::endl;
+    std::cout << "-I- Queries:          " << result.queries << " (" << result.samples << " samples, " << result.failed
+              << " failed) in " << result.duration_s << " s, " << result.samples_per_second << " samples/s" << std::endl;
+    std::cout << "-I- Latency:          mean " << result.latency_mean_ms << " ms, p50 " << result.latency_p50_ms << " ms, p90 "
+              << result.latency_p90_ms << " ms, p99 " << result.latency_p99_ms << " ms, max " << result.latency_max_ms << " ms" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+#endif /* _LOAD_SCENARIOS_HPP_ */
@@ -0,0 +1,331 @@
+#include "memory_profiler.hpp"
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "psapi.lib")
+#endif
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(__unix__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> g_alloc_count{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+
+#if !defined(_WIN32)
+void read_rusage(MemorySnapshot &snapshot)
+{
+    struct rusage usage {};
+    if (0 != getrusage(RUSAGE_SELF, &usage)) return;
+#if defined(__APPLE__)
+    snapshot.peak_rss_bytes = static_cast<size_t>(usage.ru_maxrss);         // bytes on macOS
+#else
+    snapshot.peak_rss_bytes = static_cast<size_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+#endif
+    snapshot.minor_faults = static_cast<uint64_t>(usage.ru_minflt);
+    snapshot.major_faults = static_cast<uint64_t>(usage.ru_majflt);
+}
+#endif
+
+} // namespace
+
+#ifdef AI_BMT_COUNT_ALLOCATIONS
+namespace {
+
+void count_allocation(size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void *aligned_malloc(size_t size, std::align_val_t alignment)
+{
+    const size_t align = std::max(static_cast<size_t>(alignment), sizeof(void *));
+#if defined(_WIN32)
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void *ptr = nullptr;
+    return 0 == posix_memalign(&ptr, align, size ? size : 1) ? ptr : nullptr;
+#endif
+}
+
+void aligned_free(void *ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace
+
+// Counting replacements of the global allocation functions, plain and over-aligned (types with
+// alignas above __STDCPP_DEFAULT_NEW_ALIGNMENT__, such as ORT's and the vectorized kernels' buffers,
+// go through the align_val_t forms). The array forms are replaced too, so each one is counted once
+// whether or not the standard library forwards them.
+void *operator new(size_t size)
+{
+    count_allocation(size);
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    count_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    count_allocation(size);
+    if (void *ptr = aligned_malloc(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    count_allocation(size);
+    return aligned_malloc(size, alignment);
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void *operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept { return operator new(size, alignment, tag); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { aligned_free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { aligned_free(ptr); }
+#endif
+
+bool allocation_counting_enabled()
+{
+#ifdef AI_BMT_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MemorySnapshot take_memory_snapshot()
+{
+    MemorySnapshot snapshot;
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        snapshot.rss_bytes = counters.WorkingSetSize;
+        snapshot.peak_rss_bytes = counters.PeakWorkingSetSize;
+        snapshot.minor_faults = counters.PageFaultCount;  // Windows does not split soft and hard faults
+    }
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (KERN_SUCCESS == task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count)) {
+        snapshot.rss_bytes = info.resident_size;
+    }
+    read_rusage(snapshot);
+#elif defined(__unix__)
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (FILE *statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long size_pages = 0, resident_pages = 0;
+        if (2 == std::fscanf(statm, "%lu %lu", &size_pages, &resident_pages)) {
+            snapshot.rss_bytes = resident_pages * page_size;
+        }
+        std::fclose(statm);
+    }
+    read_rusage(snapshot);
+#endif
+    snapshot.alloc_count = g_alloc_count.load(std::memory_order_relaxed);
+    snapshot.alloc_bytes = g_alloc_bytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+const char *memory_phase_name(MemoryPhase phase)
+{
+    switch (phase) {
+        case MemoryPhase::Initialize: return "initialize";
+        case MemoryPhase::Preprocess: return "preprocess";
+        case MemoryPhase::Infer: return "infer";
+        case MemoryPhase::ResultHandoff: return "result_handoff";
+        default: return "unknown";
+    }
+}
+
+std::string memory_report_to_json(const MemoryReport &report)
+{
+    auto snapshot_json = [](std::ostringstream &out, const MemorySnapshot &s) {
+        out << "{\"rss_bytes\": " << s.rss_bytes
+            << ", \"peak_rss_bytes\": " << s.peak_rss_bytes
+            << ", \"minor_faults\": " << s.minor_faults
+            << ", \"major_faults\": " << s.major_faults
+            << ", \"alloc_count\": " << s.alloc_count
+            << ", \"alloc_bytes\": " << s.alloc_bytes << "}";
+    };
+
+    std::ostringstream out;
+    out << "{\n  \"allocation_counting\": " << (report.allocation_counting ? "true" : "false") << ",\n";
+    out << "  \"start\": ";
+    snapshot_json(out, report.start);
+    out << ",\n  \"end\": ";
+    snapshot_json(out, report.current);
+    out << ",\n  \"phases\": {";
+    for (size_t i = 0; i < report.phases.size(); ++i) {
+        const PhaseMemoryStats &p = report.phases[i];
+        out << (i ? "," : "") << "\n    \"" << memory_phase_name(static_cast<MemoryPhase>(i)) << "\": {"
+            << "\"calls\": " << p.calls
+            << ", \"seconds\": " << p.seconds
+            << ", \"alloc_count\": " << p.alloc_count
+            << ", \"alloc_bytes\": " << p.alloc_bytes
+            << ", \"minor_faults\": " << p.minor_faults
+            << ", \"major_faults\": " << p.major_faults
+            << ", \"max_rss_growth_bytes\": " << p.max_rss_growth_bytes
+            << ", \"max_rss_bytes\": " << p.max_rss_bytes
+            << ", \"peak_rss_bytes\": " << p.peak_rss_bytes << "}";
+    }
+    out << "\n  }\n}\n";
+    return out.str();
+}
+
+void print_memory_report(const MemoryReport &report)
+{
+    constexpr double MB = 1024.0 * 1024.0;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Memory footprint per phase" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- RSS now " << report.current.rss_bytes / MB << " MB, peak " << report.current.peak_rss_bytes / MB
+              << " MB (started at " << report.start.rss_bytes / MB << " MB)" << std::endl;
+    for (size_t i = 0; i < report.phases.size(); ++i) {
+        const PhaseMemoryStats &p = report.phases[i];
+        if (0 == p.calls) continue;
+        std::cout << "-I- " << memory_phase_name(static_cast<MemoryPhase>(i)) << ": " << p.calls << " calls, max RSS "
+                  << p.max_rss_bytes / MB << " MB, max growth " << p.max_rss_growth_bytes / MB << " MB, faults "
+                  << p.minor_faults << " minor / " << p.major_faults << " major";
+        if (report.allocation_counting) {
+            std::cout << ", " << p.alloc_count << " allocs / " << p.alloc_bytes / MB << " MB";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+Memory_Profiling_Submitter_Implementation::Memory_Profiling_Submitter_Implementation(
+    std::shared_ptr<AI_BMT_Interface> inner, std::string report_path)
+    : inner(std::move(inner)), report_path(std::move(report_path))
+{
+    report.start = take_memory_snapshot();
+    report.allocation_counting = allocation_counting_enabled();
+}
+
+Memory_Profiling_Submitter_Implementation::~Memory_Profiling_Submitter_Implementation()
+{
+    if (!report_path.empty()) {
+        write_report(report_path);
+    }
+}
+
+void Memory_Profiling_Submitter_Implementation::close_handoff(const MemorySnapshot &now)
+{
+    MemorySnapshot start;
+    double seconds = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!handoff_pending) return;
+        handoff_pending = false;
+        start = handoff_start;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - handoff_start_time).count();
+    }
+    record(MemoryPhase::ResultHandoff, start, now, seconds);
+}
+
+void Memory_Profiling_Submitter_Implementation::record(MemoryPhase phase, const MemorySnapshot &before,
+                                                       const MemorySnapshot &after, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    PhaseMemoryStats &p = report.phases[static_cast<size_t>(phase)];
+    p.calls++;
+    p.seconds += seconds;
+    p.alloc_count += after.alloc_count - before.alloc_count;
+    p.alloc_bytes += after.alloc_bytes - before.alloc_bytes;
+    p.minor_faults += after.minor_faults - before.minor_faults;
+    p.major_faults += after.major_faults - before.major_faults;
+    p.max_rss_growth_bytes = std::max(p.max_rss_growth_bytes,
+                                      static_cast<int64_t>(after.rss_bytes) - static_cast<int64_t>(before.rss_bytes));
+    p.max_rss_bytes = std::max(p.max_rss_bytes, after.rss_bytes);
+    p.peak_rss_bytes = after.peak_rss_bytes;
+}
+
+void Memory_Profiling_Submitter_Implementation::initialize(string modelPath)
+{
+    MemorySnapshot before = take_memory_snapshot();
+    auto start = std::chrono::steady_clock::now();
+    inner->initialize(modelPath);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    record(MemoryPhase::Initialize, before, take_memory_snapshot(), elapsed.count());
+}
+
+VariantType Memory_Profiling_Submitter_Implementation::preprocessVisionData(const string &imagePath)
+{
+    return measure(MemoryPhase::Preprocess, [&] { return inner->preprocessVisionData(imagePath); });
+}
+
+VariantType Memory_Profiling_Submitter_Implementation::preprocessLLMData(const LLMPreprocessedInput &llmData)
+{
+    return measure(MemoryPhase::Preprocess, [&] { return inner->preprocessLLMData(llmData); });
+}
+
+vector<BMTVisionResult> Memory_Profiling_Submitter_Implementation::inferVision(const vector<VariantType> &data)
+{
+    return measure(MemoryPhase::Infer, [&] { return inner->inferVision(data); });
+}
+
+vector<BMTLLMResult> Memory_Profiling_Submitter_Implementation::inferLLM(const vector<VariantType> &data)
+{
+    return measure(MemoryPhase::Infer, [&] { return inner->inferLLM(data); });
+}
+
+MemoryReport Memory_Profiling_Submitter_Implementation::get_report()
+{
+    MemorySnapshot now = take_memory_snapshot();
+    close_handoff(now);
+    std::lock_guard<std::mutex> lock(mutex);
+    MemoryReport copy = report;
+    copy.current = now;
+    return copy;
+}
+
+bool Memory_Profiling_Submitter_Implementation::write_report(const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open memory report " << path << std::endl;
+        return false;
+    }
+    file << memory_report_to_json(get_report());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,125 @@
+#ifndef _MEMORY_PROFILER_HPP_
+#define _MEMORY_PROFILER_HPP_
+
+#include "ai_bmt_interface.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Process-wide memory counters at one point in time.
+struct MemorySnapshot {
+    size_t rss_bytes = 0;          // current resident set size
+    size_t peak_rss_bytes = 0;     // resident high-water mark since process start
+    uint64_t minor_faults = 0;     // page faults served without I/O (first touch, copy-on-write)
+    uint64_t major_faults = 0;     // page faults that needed I/O
+    uint64_t alloc_count = 0;      // operator new calls (0 unless allocation counting is compiled in)
+    uint64_t alloc_bytes = 0;      // bytes requested through operator new
+};
+
+// Reads RSS and fault counters from the OS (/proc/self/statm + getrusage on Linux, mach task info on
+// macOS, GetProcessMemoryInfo on Windows) and the global allocation counters.
+MemorySnapshot take_memory_snapshot();
+
+// True when memory_profiler.cpp was built with AI_BMT_COUNT_ALLOCATIONS, which replaces the global
+// operator new/delete with counting versions. Off by default: the counters are two relaxed atomic
+// increments per allocation, but replacing operator new is a link-wide decision.
+bool allocation_counting_enabled();
+
+enum class MemoryPhase {
+    Initialize,
+    Preprocess,
+    Infer,
+    ResultHandoff,   // from inferVision/inferLLM returning to the next call into the submitter
+    Count
+};
+
+const char *memory_phase_name(MemoryPhase phase);
+
+struct PhaseMemoryStats {
+    size_t calls = 0;
+    double seconds = 0;
+    uint64_t alloc_count = 0;
+    uint64_t alloc_bytes = 0;
+    uint64_t minor_faults = 0;
+    uint64_t major_faults = 0;
+    int64_t max_rss_growth_bytes = 0;  // largest RSS increase across a single call of this phase
+    size_t max_rss_bytes = 0;          // largest RSS observed at the end of a call
+    size_t peak_rss_bytes = 0;         // process high-water mark at the end of the last call
+};
+
+struct MemoryReport {
+    std::array<PhaseMemoryStats, static_cast<size_t>(MemoryPhase::Count)> phases;
+    MemorySnapshot start;              // when the profiler was created
+    MemorySnapshot current;            // when the report was taken
+    bool allocation_counting = false;
+
+    const PhaseMemoryStats &phase(MemoryPhase p) const { return phases[static_cast<size_t>(p)]; }
+};
+
+std::string memory_report_to_json(const MemoryReport &report);
+void print_memory_report(const MemoryReport &report);
+
+// Wraps a submitter and records memory per benchmark phase, e.g.
+//   auto profiled = std::make_shared<Memory_Profiling_Submitter_Implementation>(
+//       std::make_shared<Segmentation_Interface_Implementation>(), "memory_report.json");
+//
+// Counters are process-wide, so a phase also sees allocations made by other threads while it runs;
+// the result hand-off phase is where the driver copies and scores the returned results.
+// The JSON report is written to `report_path` (if non-empty) when the wrapper is destroyed.
+class Memory_Profiling_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    std::shared_ptr<AI_BMT_Interface> inner;
+    std::string report_path;
+
+    mutable std::mutex mutex;
+    MemoryReport report;
+    bool handoff_pending = false;
+    MemorySnapshot handoff_start;
+    std::chrono::steady_clock::time_point handoff_start_time;
+
+    void close_handoff(const MemorySnapshot &now);
+    void record(MemoryPhase phase, const MemorySnapshot &before, const MemorySnapshot &after, double seconds);
+
+    template <typename Fn>
+    auto measure(MemoryPhase phase, Fn &&fn) -> decltype(fn())
+    {
+        MemorySnapshot before = take_memory_snapshot();
+        close_handoff(before);
+        auto start = std::chrono::steady_clock::now();
+        auto result = fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        MemorySnapshot after = take_memory_snapshot();
+        record(phase, before, after, elapsed.count());
+        if (MemoryPhase::Infer == phase) {
+            std::lock_guard<std::mutex> lock(mutex);
+            handoff_pending = true;
+            handoff_start = after;
+            handoff_start_time = std::chrono::steady_clock::now();
+        }
+        return result;
+    }
+
+public:
+    explicit Memory_Profiling_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner,
+                                                       std::string report_path = "");
+    ~Memory_Profiling_Submitter_Implementation() override;
+
+    virtual InterfaceType getInterfaceType() override { return inner->getInterfaceType(); }
+    virtual Optional_Data getOptionalData() override { return inner->getOptionalData(); }
+
+    virtual void initialize(string modelPath) override;
+    virtual VariantType preprocessVisionData(const string &imagePath) override;
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override;
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override;
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override;
+
+    // Snapshot of the per-phase counters; an open result hand-off is closed at the current time.
+    MemoryReport get_report();
+    bool write_report(const std::string &path);
+};
+
+#endif /* _MEMORY_PROFILER_HPP_ */
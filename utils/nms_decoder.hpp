@@ -0,0 +1,131 @@
+#ifndef _NMS_DECODER_HPP_
+#define _NMS_DECODER_HPP_
+
+#include "label_type.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <limits>
+
+// One box of the HailoRT NMS-by-class float32 output (same layout as hailo_bbox_float32_t).
+// The buffer holds, for each class: a float box count followed by that many boxes.
+struct NmsBox {
+    float y_min;
+    float x_min;
+    float y_max;
+    float x_max;
+    float score;
+};
+
+// Caller-owned, structure-of-arrays detection buffers. Size them once with reserve() and reuse
+// them for every frame; decode_nms() never allocates.
+struct NmsDetections {
+    std::vector<float> x_min;
+    std::vector<float> y_min;
+    std::vector<float> x_max;
+    std::vector<float> y_max;
+    std::vector<float> score;
+    std::vector<uint16_t> class_id;  // 0-based NMS class slot
+    size_t count = 0;
+
+    void reserve(size_t max_class_count, size_t max_bboxes_per_class)
+    {
+        const size_t capacity = max_class_count * max_bboxes_per_class;
+        x_min.resize(capacity);
+        y_min.resize(capacity);
+        x_max.resize(capacity);
+        y_max.resize(capacity);
+        score.resize(capacity);
+        class_id.resize(capacity);
+        count = 0;
+    }
+
+    size_t capacity() const { return class_id.size(); }
+};
+
+struct NmsDecodeResult {
+    size_t decoded = 0;  // detections written to the output
+    size_t dropped = 0;  // detections that did not fit in the output capacity
+};
+
+// Walks the NMS buffer once and calls emit(class_slot, box) for every detection.
+// Reads are bounded by `buffer_size`; a truncated buffer simply ends the walk, and a negative or NaN
+// box count (a corrupt buffer) ends it before the count is used.
+template <typename Emit>
+inline void for_each_nms_box(const uint8_t *data, size_t buffer_size, size_t max_class_count, Emit &&emit)
+{
+    size_t offset = 0;
+    for (size_t class_slot = 0; class_slot < max_class_count; class_slot++) {
+        if (offset + sizeof(float) > buffer_size) return;
+        float det_count_f;
+        std::memcpy(&det_count_f, data + offset, sizeof(float));
+        offset += sizeof(float);
+
+        if (!(det_count_f >= 0)) return;
+        // Counts past the end of the buffer are clamped before the cast, which keeps it defined.
+        const size_t boxes_left = (buffer_size - offset) / sizeof(NmsBox);
+        const bool truncated = !(det_count_f < static_cast<float>(boxes_left));
+        const size_t det_count = truncated ? boxes_left : static_cast<size_t>(det_count_f);
+        for (size_t j = 0; j < det_count; j++) {
+            if (offset + sizeof(NmsBox) > buffer_size) return;
+            NmsBox box;
+            std::memcpy(&box, data + offset, sizeof(NmsBox));
+            offset += sizeof(NmsBox);
+            emit(class_slot, box);
+        }
+        if (truncated) return;
+    }
+}
+
+// Decodes into structure-of-arrays buffers (normalized [0, 1] coordinates).
+inline NmsDecodeResult decode_nms(const uint8_t *data, size_t max_class_count, NmsDetections &out,
+                                  size_t buffer_size = std::numeric_limits<size_t>::max())
+{
+    NmsDecodeResult result;
+    const size_t capacity = out.capacity();
+    for_each_nms_box(data, buffer_size, max_class_count, [&](size_t class_slot, const NmsBox &box) {
+        if (result.decoded == capacity) {
+            result.dropped++;
+            return;
+        }
+        const size_t i = result.decoded++;
+        out.x_min[i] = box.x_min;
+        out.y_min[i] = box.y_min;
+        out.x_max[i] = box.x_max;
+        out.y_max[i] = box.y_max;
+        out.score[i] = box.score;
+        out.class_id[i] = static_cast<uint16_t>(class_slot);
+    });
+    out.count = result.decoded;
+    return result;
+}
+
+// Decodes straight into scoring results, scaled to pixel coordinates of a frame_width x frame_height
+// image. classIndex is the 0-based COCO class slot. `out` is cleared and filled up to its current
+// capacity (reserve it once with max_class_count * max_bboxes_per_class), so it is never reallocated.
+inline NmsDecodeResult decode_nms_to_coco(const uint8_t *data, size_t max_class_count,
+                                          float frame_width, float frame_height,
+                                          std::vector<Coco17DetectionResult> &out,
+                                          size_t buffer_size = std::numeric_limits<size_t>::max())
+{
+    NmsDecodeResult result;
+    out.clear();
+    const size_t capacity = out.capacity();
+    for_each_nms_box(data, buffer_size, max_class_count, [&](size_t class_slot, const NmsBox &box) {
+        if (out.size() == capacity) {
+            result.dropped++;
+            return;
+        }
+        out.emplace_back(static_cast<int>(class_slot),
+                         box.x_min * frame_width,
+                         box.y_min * frame_height,
+                         (box.x_max - box.x_min) * frame_width,
+                         (box.y_max - box.y_min) * frame_height,
+                         box.score);
+    });
+    result.decoded = out.size();
+    return result;
+}
+
+#endif /* _NMS_DECODER_HPP_ */
@@ -0,0 +1,575 @@
+#include "run_report.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+extern char **environ;
+#endif
+
+namespace {
+
+std::string json_string(const std::string &s)
+{
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                else out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+template <typename T>
+void json_array(std::ostringstream &out, const std::vector<T> &values)
+{
+    out << '[';
+    for (size_t i = 0; i < values.size(); ++i) out << (i ? "," : "") << values[i];
+    out << ']';
+}
+
+void json_pairs(std::ostringstream &out, const std::vector<std::pair<std::string, std::string>> &pairs)
+{
+    out << '{';
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        out << (i ? ", " : "") << json_string(pairs[i].first) << ": " << json_string(pairs[i].second);
+    }
+    out << '}';
+}
+
+// Minimal JSON reader: enough for the files run_report_to_json writes (objects, arrays, strings,
+// numbers, booleans, null), without external dependencies.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> items;           // array elements or object values
+    std::vector<std::string> keys;          // object keys, parallel to items
+
+    const JsonValue *find(const std::string &key) const
+    {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) return &items[i];
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser
+{
+private:
+    const std::string &text;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string &what) const
+    {
+        throw std::runtime_error("Malformed run report JSON at offset " + std::to_string(pos) + ": " + what);
+    }
+
+    void skip_whitespace()
+    {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    }
+
+    void expect(char c)
+    {
+        skip_whitespace();
+        if (pos >= text.size() || text[pos] != c) fail(std::string("expected '") + c + "'");
+        ++pos;
+    }
+
+    bool consume(const char *literal)
+    {
+        const size_t len = std::strlen(literal);
+        if (0 != text.compare(pos, len, literal)) return false;
+        pos += len;
+        return true;
+    }
+
+    std::string parse_string()
+    {
+        expect('"');
+        std::string out;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) fail("unterminated escape");
+            char e = text[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (pos + 4 > text.size()) fail("short \\u escape");
+                    unsigned code = static_cast<unsigned>(std::stoul(text.substr(pos, 4), nullptr, 16));
+                    pos += 4;
+                    // Control characters are all the writer escapes; anything else is kept as UTF-8.
+                    if (code < 0x80) out += static_cast<char>(code);
+                    else if (code < 0x800) {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: out += e; break;
+            }
+        }
+        if (pos >= text.size()) fail("unterminated string");
+        ++pos;
+        return out;
+    }
+
+public:
+    explicit JsonParser(const std::string &text) : text(text) {}
+
+    JsonValue parse_document()
+    {
+        JsonValue value = parse_value();
+        skip_whitespace();
+        if (pos != text.size()) fail("trailing characters");
+        return value;
+    }
+
+    JsonValue parse_value()
+    {
+        skip_whitespace();
+        if (pos >= text.size()) fail("unexpected end");
+        JsonValue value;
+        const char c = text[pos];
+        if ('{' == c) {
+            value.type = JsonValue::Type::Object;
+            ++pos;
+            skip_whitespace();
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return value;
+            }
+            do {
+                skip_whitespace();
+                value.keys.push_back(parse_string());
+                expect(':');
+                value.items.push_back(parse_value());
+                skip_whitespace();
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            expect('}');
+        } else if ('[' == c) {
+            value.type = JsonValue::Type::Array;
+            ++pos;
+            skip_whitespace();
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return value;
+            }
+            do {
+                value.items.push_back(parse_value());
+                skip_whitespace();
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            expect(']');
+        } else if ('"' == c) {
+            value.type = JsonValue::Type::String;
+            value.string = parse_string();
+        } else if (consume("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+        } else if (consume("false")) {
+            value.type = JsonValue::Type::Bool;
+        } else if (consume("null")) {
+            value.type = JsonValue::Type::Null;
+        } else {
+            const char *begin = text.c_str() + pos;
+            char *end = nullptr;
+            value.number = std::strtod(begin, &end);
+            if (end == begin) fail("unexpected character");
+            value.type = JsonValue::Type::Number;
+            pos += static_cast<size_t>(end - begin);
+        }
+        return value;
+    }
+};
+
+double number_field(const JsonValue &object, const std::string &key)
+{
+    const JsonValue *value = object.find(key);
+    return (value && value->type == JsonValue::Type::Number) ? value->number : 0;
+}
+
+std::string string_field(const JsonValue &object, const std::string &key)
+{
+    const JsonValue *value = object.find(key);
+    return (value && value->type == JsonValue::Type::String) ? value->string : "";
+}
+
+std::vector<std::pair<std::string, std::string>> pairs_field(const JsonValue &object, const std::string &key)
+{
+    std::vector<std::pair<std::string, std::string>> pairs;
+    const JsonValue *value = object.find(key);
+    if (!value || value->type != JsonValue::Type::Object) return pairs;
+    for (size_t i = 0; i < value->keys.size(); ++i) pairs.emplace_back(value->keys[i], value->items[i].string);
+    return pairs;
+}
+
+template <typename T>
+std::vector<T> array_field(const JsonValue &object, const std::string &key)
+{
+    std::vector<T> values;
+    const JsonValue *value = object.find(key);
+    if (!value || value->type != JsonValue::Type::Array) return values;
+    for (const auto &item : value->items) values.push_back(static_cast<T>(item.number));
+    return values;
+}
+
+double percentile_sorted(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+// Statistics compared between runs, computed from (possibly resampled) calls, time windows and
+// preprocess samples.
+enum Stat { WallThroughput, CallThroughput, LatencyMean, LatencyP50, LatencyP90, LatencyP99, PreprocessMean, StatCount };
+
+void compute_stats(const std::vector<double> &call_ms, const std::vector<uint32_t> &call_queries,
+                   const std::vector<size_t> &call_idx, const std::vector<double> &preprocess_ms,
+                   const std::vector<size_t> &preprocess_idx, std::vector<double> &latencies, double *stats)
+{
+    double ms_sum = 0, weighted_sum = 0;
+    size_t queries = 0;
+    latencies.clear();
+    for (size_t i : call_idx) {
+        ms_sum += call_ms[i];
+        queries += call_queries[i];
+        weighted_sum += call_ms[i] * call_queries[i];
+        latencies.insert(latencies.end(), call_queries[i], call_ms[i]);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    stats[CallThroughput] = ms_sum > 0 ? queries * 1000.0 / ms_sum : 0;
+    stats[LatencyMean] = queries ? weighted_sum / queries : 0;
+    stats[LatencyP50] = percentile_sorted(latencies, 50);
+    stats[LatencyP90] = percentile_sorted(latencies, 90);
+    stats[LatencyP99] = percentile_sorted(latencies, 99);
+    double pre_sum = 0;
+    for (size_t i : preprocess_idx) pre_sum += preprocess_ms[i];
+    stats[PreprocessMean] = preprocess_idx.empty() ? 0 : pre_sum / preprocess_idx.size();
+}
+
+// The infer wall time split into equal windows, each holding the queries of the calls that ended in
+// it. Empty for reports without call start times (schema 1).
+struct ThroughputWindows {
+    std::vector<double> queries;
+    double wall_s = 0;
+};
+
+ThroughputWindows throughput_windows(const RunReport &report)
+{
+    ThroughputWindows windows;
+    const size_t calls = std::min({report.infer_call_ms.size(), report.infer_call_queries.size(), report.infer_call_start_s.size()});
+    if (0 == calls) return windows;
+    double begin = report.infer_call_start_s[0], end = begin;
+    for (size_t i = 0; i < calls; ++i) {
+        begin = std::min(begin, report.infer_call_start_s[i]);
+        end = std::max(end, report.infer_call_start_s[i] + report.infer_call_ms[i] / 1000.0);
+    }
+    windows.wall_s = end - begin;
+    if (windows.wall_s <= 0) return windows;
+    // About ten calls per window, so a window's count is not dominated by where call ends happen to fall.
+    windows.queries.assign(std::clamp<size_t>(calls / 10, 1, 100), 0);
+    for (size_t i = 0; i < calls; ++i) {
+        const double t = (report.infer_call_start_s[i] + report.infer_call_ms[i] / 1000.0 - begin) / windows.wall_s;
+        windows.queries[std::min(windows.queries.size() - 1, static_cast<size_t>(t * windows.queries.size()))] += report.infer_call_queries[i];
+    }
+    return windows;
+}
+
+double wall_throughput(const ThroughputWindows &windows, const std::vector<size_t> &window_idx)
+{
+    if (windows.wall_s <= 0) return 0;
+    double queries = 0;
+    for (size_t i : window_idx) queries += windows.queries[i];
+    return queries / windows.wall_s;
+}
+
+// stats[b][s] for b in [0, resamples]; row 0 is the full sample, the rest are bootstrap resamples.
+std::vector<std::vector<double>> bootstrap_stats(const RunReport &report, size_t resamples, std::mt19937_64 &rng)
+{
+    const size_t calls = std::min(report.infer_call_ms.size(), report.infer_call_queries.size());
+    const size_t pre = report.preprocess_ms.size();
+    const ThroughputWindows windows = throughput_windows(report);
+    std::vector<size_t> call_idx(calls), pre_idx(pre), window_idx(windows.queries.size());
+    std::vector<double> latencies;
+    std::vector<std::vector<double>> stats(resamples + 1, std::vector<double>(StatCount, 0));
+    for (size_t i = 0; i < calls; ++i) call_idx[i] = i;
+    for (size_t i = 0; i < pre; ++i) pre_idx[i] = i;
+    for (size_t i = 0; i < window_idx.size(); ++i) window_idx[i] = i;
+    compute_stats(report.infer_call_ms, report.infer_call_queries, call_idx, report.preprocess_ms, pre_idx, latencies, stats[0].data());
+    stats[0][WallThroughput] = wall_throughput(windows, window_idx);
+
+    std::uniform_int_distribution<size_t> pick_call(0, calls ? calls - 1 : 0);
+    std::uniform_int_distribution<size_t> pick_pre(0, pre ? pre - 1 : 0);
+    std::uniform_int_distribution<size_t> pick_window(0, window_idx.empty() ? 0 : window_idx.size() - 1);
+    for (size_t b = 1; b <= resamples; ++b) {
+        for (auto &i : call_idx) i = pick_call(rng);
+        for (auto &i : pre_idx) i = pick_pre(rng);
+        for (auto &i : window_idx) i = pick_window(rng);
+        compute_stats(report.infer_call_ms, report.infer_call_queries, call_idx, report.preprocess_ms, pre_idx, latencies, stats[b].data());
+        stats[b][WallThroughput] = wall_throughput(windows, window_idx);
+    }
+    return stats;
+}
+
+} // namespace
+
+const char *interface_type_name(InterfaceType type)
+{
+    switch (type) {
+        case InterfaceType::ImageClassification: return "ImageClassification";
+        case InterfaceType::ImageClassification_CustomDataset: return "ImageClassification_CustomDataset";
+        case InterfaceType::ObjectDetection: return "ObjectDetection";
+        case InterfaceType::ObjectDetection_CustomDataset: return "ObjectDetection_CustomDataset";
+        case InterfaceType::SemanticSegmentation: return "SemanticSegmentation";
+        case InterfaceType::SemanticSegmentation_CustomDataset: return "SemanticSegmentation_CustomDataset";
+        case InterfaceType::LLM_Bert_GLUE: return "LLM_Bert_GLUE";
+        case InterfaceType::LLM_GPT2_Hellaswag: return "LLM_GPT2_Hellaswag";
+        case InterfaceType::LLM_OPT_Hellaswag: return "LLM_OPT_Hellaswag";
+        case InterfaceType::LLM_QWEN_Hellaswag: return "LLM_QWEN_Hellaswag";
+        case InterfaceType::LLM_GPT2_MMLU: return "LLM_GPT2_MMLU";
+        case InterfaceType::LLM_OPT_MMLU: return "LLM_OPT_MMLU";
+        case InterfaceType::LLM_QWEN_MMLU: return "LLM_QWEN_MMLU";
+    }
+    return "Unknown";
+}
+
+std::string run_report_to_json(const RunReport &report)
+{
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\n  \"schema_version\": " << report.schema_version
+        << ",\n  \"created\": " << json_string(report.created)
+        << ",\n  \"interface_type\": " << json_string(report.interface_type)
+        << ",\n  \"optional_data\": ";
+    json_pairs(out, report.optional_data);
+    out << ",\n  \"config\": ";
+    json_pairs(out, report.config);
+    out << ",\n  \"summary\": {\"queries\": " << report.queries
+        << ", \"infer_calls\": " << report.infer_call_ms.size()
+        << ", \"infer_wall_s\": " << report.infer_wall_s
+        << ", \"throughput_qps\": " << report.throughput_qps()
+        << ", \"initialize_s\": " << report.initialize_s << "}"
+        << ",\n  \"phases\": {\n    \"initialize_s\": " << report.initialize_s
+        << ",\n    \"preprocess_ms\": ";
+    json_array(out, report.preprocess_ms);
+    out << ",\n    \"infer_call_ms\": ";
+    json_array(out, report.infer_call_ms);
+    out << ",\n    \"infer_call_queries\": ";
+    json_array(out, report.infer_call_queries);
+    out << ",\n    \"infer_call_start_s\": ";
+    json_array(out, report.infer_call_start_s);
+    out << ",\n    \"infer_wall_s\": " << report.infer_wall_s << "\n  }\n}\n";
+    return out.str();
+}
+
+bool write_run_report(const RunReport &report, const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open run report " << path << std::endl;
+        return false;
+    }
+    file << run_report_to_json(report);
+    return static_cast<bool>(file);
+}
+
+RunReport parse_run_report(const std::string &json)
+{
+    JsonValue root = JsonParser(json).parse_document();
+    if (root.type != JsonValue::Type::Object) throw std::runtime_error("Run report is not a JSON object");
+    RunReport report;
+    report.schema_version = static_cast<int>(number_field(root, "schema_version"));
+    if (report.schema_version != 1 && report.schema_version != 2) throw std::runtime_error("Unsupported run report schema version " + std::to_string(report.schema_version));
+    report.created = string_field(root, "created");
+    report.interface_type = string_field(root, "interface_type");
+    report.optional_data = pairs_field(root, "optional_data");
+    report.config = pairs_field(root, "config");
+    if (const JsonValue *phases = root.find("phases")) {
+        report.initialize_s = number_field(*phases, "initialize_s");
+        report.preprocess_ms = array_field<double>(*phases, "preprocess_ms");
+        report.infer_call_ms = array_field<double>(*phases, "infer_call_ms");
+        report.infer_call_queries = array_field<uint32_t>(*phases, "infer_call_queries");
+        report.infer_call_start_s = array_field<double>(*phases, "infer_call_start_s");
+        report.infer_wall_s = number_field(*phases, "infer_wall_s");
+    }
+    for (uint32_t q : report.infer_call_queries) report.queries += q;
+    return report;
+}
+
+RunReport read_run_report(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Failed to open run report " + path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parse_run_report(buffer.str());
+}
+
+std::vector<double> query_latencies_ms(const RunReport &report)
+{
+    std::vector<double> latencies;
+    latencies.reserve(report.queries);
+    for (size_t i = 0; i < report.infer_call_ms.size() && i < report.infer_call_queries.size(); ++i) {
+        latencies.insert(latencies.end(), report.infer_call_queries[i], report.infer_call_ms[i]);
+    }
+    return latencies;
+}
+
+std::vector<MetricComparison> compare_run_reports(const RunReport &baseline, const RunReport &candidate,
+                                                  const RunComparisonConfig &config)
+{
+    std::mt19937_64 rng(config.seed);
+    const size_t resamples = std::max<size_t>(100, config.resamples);
+    const auto base = bootstrap_stats(baseline, resamples, rng);
+    const auto cand = bootstrap_stats(candidate, resamples, rng);
+
+    const struct {
+        Stat stat;
+        const char *name;
+        bool higher_is_better;
+        bool gating;
+    } metrics[] = {
+        {WallThroughput, "throughput_qps", true, true},
+        {CallThroughput, "call_throughput_qps", true, false},
+        {LatencyMean, "latency_mean_ms", false, true},
+        {LatencyP50, "latency_p50_ms", false, true},
+        {LatencyP90, "latency_p90_ms", false, true},
+        {LatencyP99, "latency_p99_ms", false, true},
+        {PreprocessMean, "preprocess_mean_ms", false, true},
+    };
+
+    const double alpha = (1.0 - config.confidence) / 2.0;
+    std::vector<MetricComparison> comparisons;
+    for (const auto &metric : metrics) {
+        MetricComparison c;
+        c.name = metric.name;
+        c.higher_is_better = metric.higher_is_better;
+        c.gating = metric.gating;
+        c.baseline = base[0][metric.stat];
+        c.candidate = cand[0][metric.stat];
+        if (c.baseline <= 0 || c.candidate <= 0) continue; // metric absent from one of the runs
+        c.relative_change = (c.candidate - c.baseline) / c.baseline;
+
+        std::vector<double> deltas;
+        for (size_t b = 1; b <= resamples; ++b) {
+            if (base[b][metric.stat] > 0) deltas.push_back((cand[b][metric.stat] - base[b][metric.stat]) / base[b][metric.stat]);
+        }
+        std::sort(deltas.begin(), deltas.end());
+        c.ci_low = percentile_sorted(deltas, alpha * 100);
+        c.ci_high = percentile_sorted(deltas, (1.0 - alpha) * 100);
+        c.significant = c.ci_low > 0 || c.ci_high < 0;
+        c.regression = c.gating && (c.higher_is_better ? c.ci_high < -config.tolerance : c.ci_low > config.tolerance);
+        comparisons.push_back(c);
+    }
+    return comparisons;
+}
+
+void print_run_comparison(const std::vector<MetricComparison> &comparisons)
+{
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Run comparison (candidate vs baseline)" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    for (const auto &c : comparisons) {
+        std::cout << "-I- " << std::left << std::setw(20) << c.name << std::right << c.baseline << " -> " << c.candidate
+                  << "  " << std::showpos << c.relative_change * 100 << "% [" << c.ci_low * 100 << "%, " << c.ci_high * 100
+                  << "%]" << std::noshowpos
+                  << (c.regression ? "  REGRESSION" : c.significant ? "  significant" : "  within noise")
+                  << (c.gating ? "" : " (not gating)") << std::endl;
+    }
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+Run_Recording_Submitter_Implementation::Run_Recording_Submitter_Implementation(
+    std::shared_ptr<AI_BMT_Interface> inner, std::string path, std::vector<std::pair<std::string, std::string>> config)
+    : inner(std::move(inner)), path(std::move(path))
+{
+    report.config = std::move(config);
+    // The AI_BMT_* variables select placement, replicas and similar modes, so they belong to the run's configuration.
+#if defined(_WIN32)
+    char **env = _environ;
+#else
+    char **env = environ;
+#endif
+    for (; env && *env; ++env) {
+        std::string entry = *env;
+        const size_t eq = entry.find('=');
+        if (0 == entry.compare(0, 7, "AI_BMT_") && std::string::npos != eq) {
+            report.config.emplace_back("env." + entry.substr(0, eq), entry.substr(eq + 1));
+        }
+    }
+    std::time_t now = std::time(nullptr);
+    char created[32] = {};
+    if (const std::tm *utc = std::gmtime(&now)) std::strftime(created, sizeof(created), "%Y-%m-%dT%H:%M:%SZ", utc);
+    report.created = created;
+}
+
+Run_Recording_Submitter_Implementation::~Run_Recording_Submitter_Implementation()
+{
+    if (!path.empty()) write_run_report(get_report(), path);
+}
+
+void Run_Recording_Submitter_Implementation::initialize(string modelPath)
+{
+    auto start = Clock::now();
+    inner->initialize(modelPath);
+    std::lock_guard<std::mutex> lock(mutex);
+    report.initialize_s = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+RunReport Run_Recording_Submitter_Implementation::get_report()
+{
+    RunReport copy;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        copy = report;
+    }
+    copy.interface_type = interface_type_name(inner->getInterfaceType());
+    const Optional_Data data = inner->getOptionalData();
+    copy.optional_data = {
+        {"cpu_type", data.cpu_type},
+        {"accelerator_type", data.accelerator_type},
+        {"submitter", data.submitter},
+        {"cpu_core_count", data.cpu_core_count},
+        {"cpu_ram_capacity", data.cpu_ram_capacity},
+        {"cooling", data.cooling},
+        {"cooling_option", data.cooling_option},
+        {"cpu_accelerator_interconnect_interface", data.cpu_accelerator_interconnect_interface},
+        {"benchmark_model", data.benchmark_model},
+        {"operating_system", data.operating_system},
+    };
+    return copy;
+}
@@ -0,0 +1,154 @@
+#ifndef _RUN_REPORT_HPP_
+#define _RUN_REPORT_HPP_
+
+#include "ai_bmt_interface.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Self-describing record of one benchmark run, written as JSON so two runs can be compared locally
+// (benchmark/compare_runs). Everything needed to tell runs apart travels with the numbers.
+struct RunReport {
+    int schema_version = 2;                                         // 2 adds infer_call_start_s; 1 is still read
+    std::string created;                                            // UTC, ISO 8601
+    std::string interface_type;
+    std::vector<std::pair<std::string, std::string>> optional_data; // Optional_Data fields
+    std::vector<std::pair<std::string, std::string>> config;        // caller-supplied settings and AI_BMT_* environment
+    double initialize_s = 0;
+    std::vector<double> preprocess_ms;                              // per preprocess call
+    std::vector<double> infer_call_ms;                              // per inferVision/inferLLM call
+    std::vector<uint32_t> infer_call_queries;                       // queries in that call
+    std::vector<double> infer_call_start_s;                         // when that call started, seconds on the recorder's clock
+    double infer_wall_s = 0;                                        // first infer call start -> last infer call end
+    size_t queries = 0;
+
+    double throughput_qps() const { return infer_wall_s > 0 ? queries / infer_wall_s : 0; }
+};
+
+const char *interface_type_name(InterfaceType type);
+
+std::string run_report_to_json(const RunReport &report);
+bool write_run_report(const RunReport &report, const std::string &path);
+// Throws std::runtime_error on unreadable files or malformed JSON.
+RunReport parse_run_report(const std::string &json);
+RunReport read_run_report(const std::string &path);
+
+// Per-query latency: each query of a call completes when the call returns.
+std::vector<double> query_latencies_ms(const RunReport &report);
+
+struct MetricComparison {
+    std::string name;
+    bool higher_is_better = false;
+    double baseline = 0;
+    double candidate = 0;
+    double relative_change = 0;       // (candidate - baseline) / baseline
+    double ci_low = 0;                // bootstrap confidence interval of relative_change
+    double ci_high = 0;
+    bool significant = false;         // the interval excludes 0
+    bool gating = true;               // false: reported for context, never counted as a regression
+    bool regression = false;          // gating, significant, worse, and worse by more than the tolerance
+};
+
+struct RunComparisonConfig {
+    size_t resamples = 2000;
+    double confidence = 0.95;
+    double tolerance = 0.02;          // relative change treated as noise even if significant
+    uint64_t seed = 42;
+};
+
+// Compares wall-clock throughput, mean/p50/p90/p99 query latency and mean preprocess time with
+// percentile-bootstrap confidence intervals. Throughput is queries completed per second of infer wall
+// time, bootstrapped over time windows of the run (calls are placed by their start timestamps), so
+// concurrent callers count as the driver saw them. Calls and preprocess samples are resampled
+// independently for the other metrics. The sum-of-latency figure (queries / summed call time) is
+// reported as call_throughput_qps for context only: it drops when calls overlap even if the run got
+// faster, so it never gates.
+std::vector<MetricComparison> compare_run_reports(const RunReport &baseline, const RunReport &candidate,
+                                                  const RunComparisonConfig &config = RunComparisonConfig());
+void print_run_comparison(const std::vector<MetricComparison> &comparisons);
+
+// Wraps a submitter and records a RunReport, written to `path` when the wrapper is destroyed, e.g.
+//   auto recorded = std::make_shared<Run_Recording_Submitter_Implementation>(
+//       std::make_shared<ImageClassification_Interface_Implementation>(), "run_baseline.json",
+//       std::vector<std::pair<std::string, std::string>>{{"build", "release"}, {"sessions", "1"}});
+class Run_Recording_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::shared_ptr<AI_BMT_Interface> inner;
+    std::string path;
+
+    std::mutex mutex;
+    RunReport report;
+    bool infer_started = false;
+    Clock::time_point first_infer;
+    Clock::time_point last_infer_end;
+    const Clock::time_point epoch = Clock::now();   // origin of infer_call_start_s
+
+    template <typename Fn>
+    auto timed_infer(size_t queries, Fn &&fn) -> decltype(fn())
+    {
+        auto start = Clock::now();
+        auto result = fn();
+        auto end = Clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!infer_started || start < first_infer) first_infer = start;
+        if (!infer_started || end > last_infer_end) last_infer_end = end;
+        infer_started = true;
+        report.infer_call_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        report.infer_call_queries.push_back(static_cast<uint32_t>(queries));
+        report.infer_call_start_s.push_back(std::chrono::duration<double>(start - epoch).count());
+        report.queries += queries;
+        report.infer_wall_s = std::chrono::duration<double>(last_infer_end - first_infer).count();
+        return result;
+    }
+
+    template <typename Fn>
+    auto timed_preprocess(Fn &&fn) -> decltype(fn())
+    {
+        auto start = Clock::now();
+        auto result = fn();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        report.preprocess_ms.push_back(ms);
+        return result;
+    }
+
+public:
+    Run_Recording_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner, std::string path,
+                                           std::vector<std::pair<std::string, std::string>> config = {});
+    ~Run_Recording_Submitter_Implementation() override;
+
+    virtual InterfaceType getInterfaceType() override { return inner->getInterfaceType(); }
+    virtual Optional_Data getOptionalData() override { return inner->getOptionalData(); }
+    virtual void initialize(string modelPath) override;
+
+    virtual VariantType preprocessVisionData(const string &imagePath) override
+    {
+        return timed_preprocess([&] { return inner->preprocessVisionData(imagePath); });
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        return timed_preprocess([&] { return inner->preprocessLLMData(llmData); });
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        return timed_infer(data.size(), [&] { return inner->inferVision(data); });
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        return timed_infer(data.size(), [&] { return inner->inferLLM(data); });
+    }
+
+    RunReport get_report();
+};
+
+#endif /* _RUN_REPORT_HPP_ */
@@ -0,0 +1,342 @@
+#ifndef _SHARDED_SUBMITTER_HPP_
+#define _SHARDED_SUBMITTER_HPP_
+
+#include "ai_bmt_interface.h"
+#include "thread_placement.hpp"
+#include <memory>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <variant>
+
+// Per-shard counters, read with Sharded_Submitter_Implementation::get_shard_stats().
+struct ShardStats {
+    size_t queries = 0;        // queries served by this shard
+    size_t dispatches = 0;     // inferVision/inferLLM calls made on this shard
+    double busy_seconds = 0;   // wall time spent inside the shard's infer calls
+};
+
+// How a chunk of a split batch reaches a shard.
+enum class ShardInput {
+    Copy,   // the chunk holds copies of its queries; works with any submitter
+    View,   // vector<T> queries are passed as T* into the caller's vectors, without copying; the
+            // shards must accept the pointer alternatives (the vision examples accept float*)
+};
+
+// Runs N independent model instances (one per device, or one CPU session per core group)
+// behind a single AI_BMT_Interface.
+//
+// Every shard is a complete AI_BMT_Interface implementation served by its own persistent worker
+// thread. A batch handed to inferVision/inferLLM is split into index ranges of
+// `queries_per_dispatch` queries of the caller's vector; each worker pulls the next range as soon as
+// its shard is idle, so work always goes to the least-loaded instance. Results are merged back in
+// the original query order before returning. A batch that is not split is passed through as is.
+//
+// Shards must be safe to call concurrently with each other (they share no state), but each shard
+// only ever sees one call at a time. Several threads may call inferVision/inferLLM at once; their
+// ranges are served in arrival order.
+//
+// Each range costs a lock round trip and a worker wake-up, about a microsecond. When a range's
+// inference is cheaper than that (sharded_submitter_bench -input=view -compute-us=0), N shards are
+// slower than one and ranges go to whichever worker wakes first, so dispatch counts are uneven.
+// Raise `queries_per_dispatch` until a range carries at least tens of microseconds of work.
+class Sharded_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    template <typename T> struct is_vector : std::false_type {};
+    template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
+
+    // One inferVision/inferLLM call in progress. Ranges are handed out under `mutex`.
+    struct Job {
+        const std::vector<VariantType> *data = nullptr;
+        size_t chunk_size = 1;
+        size_t chunk_count = 0;
+        size_t next_chunk = 0;      // first range not handed out yet
+        size_t finished = 0;        // ranges done, failed or cancelled
+        std::function<void(AI_BMT_Interface &, const std::vector<VariantType> &, size_t chunk)> run;
+        std::exception_ptr error;
+    };
+
+    struct ShardState {
+        std::shared_ptr<AI_BMT_Interface> instance;
+        CpuSet cpus;                // where this shard's worker runs; empty = unpinned
+        size_t placement_version = 0;
+        ShardStats stats;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<ShardState>> shards;
+    size_t queries_per_dispatch;
+    ShardInput input_mode = ShardInput::Copy;
+    std::atomic<size_t> preprocess_cursor{0};
+
+    std::mutex mutex;
+    std::condition_variable cond_work;
+    std::condition_variable cond_done;
+    std::deque<Job *> jobs;         // jobs with ranges left to hand out
+    size_t placement_version = 0;
+    bool stopping = false;
+
+    // A query as a shard sees it in View mode: vectors become pointers into the caller's storage.
+    static VariantType view_of(const VariantType &query)
+    {
+        return std::visit([&](const auto &value) -> VariantType {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (is_vector<T>::value) {
+                return const_cast<typename T::value_type *>(value.data());
+            } else {
+                return query;
+            }
+        }, query);
+    }
+
+    void worker_loop(size_t shard_idx)
+    {
+        ShardState &shard = *shards[shard_idx];
+        size_t pinned_version = 0;
+        bool pinned = false;
+        std::vector<VariantType> chunk_data;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cond_work.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            if (pinned_version != shard.placement_version) {
+                pinned_version = shard.placement_version;
+                if (!shard.cpus.empty()) {
+                    pinned = pin_current_thread(shard.cpus);
+                } else if (pinned) {
+                    pin_current_thread(detect_cpu_topology().all()); // back to every online CPU
+                    pinned = false;
+                }
+            }
+
+            Job &job = *jobs.front();
+            const size_t chunk = job.next_chunk++;
+            if (job.next_chunk == job.chunk_count)
+                jobs.pop_front();
+            const ShardInput mode = input_mode;
+            lock.unlock();
+
+            const std::vector<VariantType> &data = *job.data;
+            const size_t begin = chunk * job.chunk_size;
+            const size_t end = std::min(begin + job.chunk_size, data.size());
+            std::exception_ptr error;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                if (job.chunk_count == 1) {
+                    job.run(*shard.instance, data, chunk);
+                } else {
+                    chunk_data.clear();
+                    for (size_t i = begin; i < end; ++i) {
+                        if (ShardInput::View == mode)
+                            chunk_data.push_back(view_of(data[i]));
+                        else
+                            chunk_data.push_back(data[i]);
+                    }
+                    job.run(*shard.instance, chunk_data, chunk);
+                }
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            chunk_data.clear();
+
+            lock.lock();
+            shard.stats.queries += end - begin;
+            shard.stats.dispatches++;
+            shard.stats.busy_seconds += elapsed.count();
+            job.finished++;
+            if (error) {
+                if (!job.error)
+                    job.error = error;
+                // Cancel the ranges nobody has started, so the caller gets the error early.
+                if (job.next_chunk < job.chunk_count) {
+                    job.finished += job.chunk_count - job.next_chunk;
+                    job.next_chunk = job.chunk_count;
+                    jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+                }
+            }
+            if (job.finished == job.chunk_count)
+                cond_done.notify_all();
+        }
+    }
+
+    template <typename Result, typename InferFn>
+    std::vector<Result> dispatch(const std::vector<VariantType> &data, InferFn infer_fn)
+    {
+        if (data.empty())
+            return {};
+
+        Job job;
+        job.data = &data;
+        job.chunk_size = queries_per_dispatch;
+        job.chunk_count = (data.size() + job.chunk_size - 1) / job.chunk_size;
+        std::vector<std::vector<Result>> chunk_results(job.chunk_count);
+        job.run = [&](AI_BMT_Interface &shard, const std::vector<VariantType> &chunk_data, size_t chunk) {
+            chunk_results[chunk] = infer_fn(shard, chunk_data);
+        };
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobs.push_back(&job);
+            cond_work.notify_all();
+            cond_done.wait(lock, [&] { return job.finished == job.chunk_count; });
+        }
+        if (job.error)
+            std::rethrow_exception(job.error);
+
+        if (1 == job.chunk_count)
+            return std::move(chunk_results.front());
+        std::vector<Result> results;
+        results.reserve(data.size());
+        for (auto &chunk : chunk_results) {
+            for (auto &r : chunk)
+                results.push_back(std::move(r));
+        }
+        return results;
+    }
+
+public:
+    explicit Sharded_Submitter_Implementation(std::vector<std::shared_ptr<AI_BMT_Interface>> instances,
+                                              size_t queries_per_dispatch = 1)
+        : queries_per_dispatch(std::max<size_t>(1, queries_per_dispatch))
+    {
+        if (instances.empty())
+            throw std::invalid_argument("Sharded_Submitter_Implementation needs at least one shard");
+        for (auto &instance : instances) {
+            auto shard = std::make_unique<ShardState>();
+            shard->instance = std::move(instance);
+            shards.push_back(std::move(shard));
+        }
+        for (size_t i = 0; i < shards.size(); ++i)
+            shards[i]->worker = std::thread(&Sharded_Submitter_Implementation::worker_loop, this, i);
+    }
+
+    Sharded_Submitter_Implementation(const Sharded_Submitter_Implementation &) = delete;
+    Sharded_Submitter_Implementation &operator=(const Sharded_Submitter_Implementation &) = delete;
+
+    virtual ~Sharded_Submitter_Implementation()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond_work.notify_all();
+        for (auto &shard : shards)
+            shard->worker.join();
+    }
+
+    virtual InterfaceType getInterfaceType() override
+    {
+        return shards.front()->instance->getInterfaceType();
+    }
+
+    virtual Optional_Data getOptionalData() override
+    {
+        return shards.front()->instance->getOptionalData();
+    }
+
+    // Loads the model on every shard in parallel (model loading dominates start-up on multi-device hosts).
+    virtual void initialize(string modelPath) override
+    {
+        std::vector<std::exception_ptr> errors(shards.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            threads.emplace_back([&, i] {
+                try {
+                    shards[i]->instance->initialize(modelPath);
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+        for (auto &error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    // Preprocessing is stateless per query, so calls are spread round-robin over the shards.
+    virtual VariantType preprocessVisionData(const string &imagePath) override
+    {
+        return shards[preprocess_cursor++ % shards.size()]->instance->preprocessVisionData(imagePath);
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        return shards[preprocess_cursor++ % shards.size()]->instance->preprocessLLMData(llmData);
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        return dispatch<BMTVisionResult>(data, [](AI_BMT_Interface &shard, const std::vector<VariantType> &chunk) {
+            return shard.inferVision(chunk);
+        });
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        return dispatch<BMTLLMResult>(data, [](AI_BMT_Interface &shard, const std::vector<VariantType> &chunk) {
+            return shard.inferLLM(chunk);
+        });
+    }
+
+    size_t shard_count() const { return shards.size(); }
+
+    void set_input_mode(ShardInput mode)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        input_mode = mode;
+    }
+
+    // Runs each shard's worker on its own core set, e.g. one NUMA node per shard or
+    // topology.all().split(shard_count()); a worker moves before its next range, and a worker whose
+    // set becomes empty is allowed on every online CPU again. The ORT intra-op pool of a shard is
+    // placed separately through its session options.
+    void set_shard_placement(const std::vector<CpuSet> &cpus)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        placement_version++;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            shards[i]->cpus = i < cpus.size() ? cpus[i] : CpuSet();
+            shards[i]->placement_version = placement_version;
+        }
+    }
+
+    std::vector<ShardStats> get_shard_stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ShardStats> stats;
+        for (auto &shard : shards)
+            stats.push_back(shard->stats);
+        return stats;
+    }
+};
+
+// Builds `count` independent instances of an implementation and shards over them, e.g.
+//   make_sharded_submitter<ImageClassification_Interface_Implementation>(4)
+// runs four ORT sessions on a plain CPU host in place of four accelerators.
+template <typename Implementation, typename... Args>
+std::shared_ptr<Sharded_Submitter_Implementation> make_sharded_submitter(size_t count, Args &&...args)
+{
+    std::vector<std::shared_ptr<AI_BMT_Interface>> instances;
+    for (size_t i = 0; i < count; ++i)
+        instances.push_back(std::make_shared<Implementation>(args...));
+    return std::make_shared<Sharded_Submitter_Implementation>(std::move(instances));
+}
+
+#endif /* _SHARDED_SUBMITTER_HPP_ */
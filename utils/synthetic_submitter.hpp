@@ -0,0 +1,288 @@
+#ifndef _SYNTHETIC_SUBMITTER_HPP_
+#define _SYNTHETIC_SUBMITTER_HPP_
+
+#include "ai_bmt_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+enum class SyntheticDistribution {
+    Constant,       // always `mean`
+    Uniform,        // mean +- spread
+    Normal,         // stddev = spread, clamped at 0
+    LogNormal,      // median ~ mean, spread sets the tail (stddev of the underlying normal = spread / mean)
+    Exponential,    // memoryless, rate 1 / mean (spread ignored)
+};
+
+struct SyntheticTiming {
+    SyntheticDistribution distribution = SyntheticDistribution::Constant;
+    std::chrono::microseconds mean{0};
+    std::chrono::microseconds spread{0};
+};
+
+enum class SyntheticFailureMode {
+    Throw,          // the whole inferVision/inferLLM call throws
+    DropResult,     // the failed query has no entry in the returned vector
+    EmptyResult,    // the failed query returns an empty output
+};
+
+struct SyntheticSubmitterConfig {
+    InterfaceType type = InterfaceType::ImageClassification;
+    SyntheticTiming preprocess;                                 // per preprocess call
+    SyntheticTiming per_batch;                                  // fixed cost per device batch (launch, transfer)
+    SyntheticTiming per_query{SyntheticDistribution::Constant, std::chrono::microseconds(1000), std::chrono::microseconds(0)};
+    size_t max_batch_size = 0;                                  // > 0: larger calls run as several device batches
+    bool busy_wait = false;                                     // spin instead of sleep (CPU-bound model)
+    size_t input_elements = 0;                                  // vision input floats; 0 = task default
+    std::vector<int64_t> output_shape;                          // empty = task default
+    double failure_rate = 0;                                    // probability that a query fails
+    SyntheticFailureMode failure_mode = SyntheticFailureMode::EmptyResult;
+    uint64_t seed = 42;
+};
+
+struct SyntheticSubmitterStats {
+    size_t preprocess_calls = 0;
+    size_t infer_calls = 0;
+    size_t device_batches = 0;
+    size_t queries = 0;
+    size_t failures = 0;
+    double simulated_seconds = 0;   // compute time the submitter pretended to spend
+};
+
+// AI_BMT_Interface implementation without a model, for measuring the harness itself: per-query
+// framework overhead, queueing behaviour and result hand-off cost at real output sizes.
+//
+// Every InterfaceType is supported. Outputs have the size the driver expects for the task
+// (1000 class scores, YOLOv5 25200 x 85, 21 x 520 x 520 segmentation logits, LLM logits), compute
+// time is drawn from a configurable distribution, and queries can be made to fail at a given rate.
+class Synthetic_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    SyntheticSubmitterConfig config;
+    std::mutex mutex;
+    std::mt19937_64 rng;
+    SyntheticSubmitterStats stats;
+
+    static bool is_vision(InterfaceType type)
+    {
+        return type <= InterfaceType::SemanticSegmentation_CustomDataset;
+    }
+
+    static size_t default_input_elements(InterfaceType type)
+    {
+        switch (type) {
+            case InterfaceType::ObjectDetection:
+            case InterfaceType::ObjectDetection_CustomDataset: return 3 * 640 * 640;
+            case InterfaceType::SemanticSegmentation:
+            case InterfaceType::SemanticSegmentation_CustomDataset: return 3 * 520 * 520;
+            default: return 3 * 224 * 224;
+        }
+    }
+
+    // `sequence_length` only matters for the causal LM tasks, whose logits are [1, S, vocab].
+    static std::vector<int64_t> default_output_shape(InterfaceType type, int64_t sequence_length)
+    {
+        switch (type) {
+            case InterfaceType::ImageClassification:
+            case InterfaceType::ImageClassification_CustomDataset: return {1, 1000};
+            case InterfaceType::ObjectDetection:
+            case InterfaceType::ObjectDetection_CustomDataset: return {1, 25200, 85};
+            case InterfaceType::SemanticSegmentation:
+            case InterfaceType::SemanticSegmentation_CustomDataset: return {1, 21, 520, 520};
+            case InterfaceType::LLM_Bert_GLUE: return {1, 2};
+            case InterfaceType::LLM_GPT2_Hellaswag:
+            case InterfaceType::LLM_GPT2_MMLU: return {1, sequence_length, 50257};
+            case InterfaceType::LLM_OPT_Hellaswag:
+            case InterfaceType::LLM_OPT_MMLU: return {1, sequence_length, 50272};
+            case InterfaceType::LLM_QWEN_Hellaswag:
+            case InterfaceType::LLM_QWEN_MMLU: return {1, sequence_length, 151936};
+        }
+        return {1, 1};
+    }
+
+    static size_t element_count(const std::vector<int64_t> &shape)
+    {
+        size_t count = 1;
+        for (int64_t dim : shape) count *= static_cast<size_t>(std::max<int64_t>(1, dim));
+        return count;
+    }
+
+    // Called with `mutex` held.
+    std::chrono::microseconds sample(const SyntheticTiming &timing)
+    {
+        const double mean = static_cast<double>(timing.mean.count());
+        const double spread = static_cast<double>(timing.spread.count());
+        double us = mean;
+        switch (timing.distribution) {
+            case SyntheticDistribution::Constant:
+                break;
+            case SyntheticDistribution::Uniform:
+                us = std::uniform_real_distribution<double>(mean - spread, mean + spread)(rng);
+                break;
+            case SyntheticDistribution::Normal:
+                us = std::normal_distribution<double>(mean, spread)(rng);
+                break;
+            case SyntheticDistribution::LogNormal:
+                if (mean > 0) us = std::lognormal_distribution<double>(std::log(mean), spread / mean)(rng);
+                break;
+            case SyntheticDistribution::Exponential:
+                if (mean > 0) us = std::exponential_distribution<double>(1.0 / mean)(rng);
+                break;
+        }
+        return std::chrono::microseconds(static_cast<int64_t>(std::max(0.0, us)));
+    }
+
+    void spend(std::chrono::microseconds duration)
+    {
+        if (duration.count() <= 0) return;
+        auto deadline = std::chrono::steady_clock::now() + duration;
+        if (config.busy_wait) {
+            while (std::chrono::steady_clock::now() < deadline) {
+            }
+        } else {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    // Simulates the device time of a call and decides which queries fail.
+    std::vector<bool> simulate(size_t queries)
+    {
+        std::chrono::microseconds total{0};
+        std::vector<bool> failed(queries, false);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const size_t batch_size = config.max_batch_size ? config.max_batch_size : std::max<size_t>(1, queries);
+            const size_t batches = (queries + batch_size - 1) / batch_size;
+            for (size_t b = 0; b < batches; ++b) total += sample(config.per_batch);
+            for (size_t q = 0; q < queries; ++q) total += sample(config.per_query);
+            if (config.failure_rate > 0) {
+                std::bernoulli_distribution fail(std::min(1.0, config.failure_rate));
+                for (size_t q = 0; q < queries; ++q) failed[q] = fail(rng);
+            }
+            stats.infer_calls++;
+            stats.device_batches += batches;
+            stats.queries += queries;
+            stats.failures += static_cast<size_t>(std::count(failed.begin(), failed.end(), true));
+            stats.simulated_seconds += std::chrono::duration<double>(total).count();
+        }
+        spend(total);
+        if (config.failure_mode == SyntheticFailureMode::Throw && std::find(failed.begin(), failed.end(), true) != failed.end()) {
+            throw std::runtime_error("Synthetic submitter: injected inference failure");
+        }
+        return failed;
+    }
+
+public:
+    explicit Synthetic_Submitter_Implementation(SyntheticSubmitterConfig config = SyntheticSubmitterConfig())
+        : config(std::move(config)), rng(this->config.seed)
+    {
+    }
+
+    virtual InterfaceType getInterfaceType() override { return config.type; }
+
+    virtual Optional_Data getOptionalData() override
+    {
+        Optional_Data data;
+        data.accelerator_type = "Synthetic (no model)";
+        data.benchmark_model = "Synthetic";
+        return data;
+    }
+
+    virtual void initialize(string /*modelPath*/) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = SyntheticSubmitterStats();
+        rng.seed(config.seed);
+    }
+
+    virtual VariantType preprocessVisionData(const string &/*imagePath*/) override
+    {
+        if (!is_vision(config.type)) throw runtime_error("preprocessVisionData(..) called on a synthetic LLM submitter");
+        std::chrono::microseconds duration;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            duration = sample(config.preprocess);
+            stats.preprocess_calls++;
+        }
+        spend(duration);
+        return vector<float>(config.input_elements ? config.input_elements : default_input_elements(config.type));
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        if (is_vision(config.type)) throw runtime_error("preprocessLLMData(..) called on a synthetic vision submitter");
+        std::chrono::microseconds duration;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            duration = sample(config.preprocess);
+            stats.preprocess_calls++;
+        }
+        spend(duration);
+        return llmData;
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        std::vector<bool> failed = simulate(data.size());
+        const size_t elements = element_count(config.output_shape.empty() ? default_output_shape(config.type, 1) : config.output_shape);
+
+        vector<BMTVisionResult> results;
+        results.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (failed[i] && config.failure_mode == SyntheticFailureMode::DropResult) continue;
+            BMTVisionResult result;
+            if (!failed[i]) {
+                switch (config.type) {
+                    case InterfaceType::ObjectDetection:
+                    case InterfaceType::ObjectDetection_CustomDataset:
+                        result.objectDetectionResult.assign(elements, 0.0f);
+                        break;
+                    case InterfaceType::SemanticSegmentation:
+                    case InterfaceType::SemanticSegmentation_CustomDataset:
+                        result.segmentationResult.assign(elements, 0.0f);
+                        break;
+                    default:
+                        result.classProbabilities.assign(elements, 1.0f / elements);
+                        break;
+                }
+            }
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        std::vector<bool> failed = simulate(data.size());
+
+        vector<BMTLLMResult> results;
+        results.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (failed[i] && config.failure_mode == SyntheticFailureMode::DropResult) continue;
+            BMTLLMResult result;
+            if (!failed[i]) {
+                int64_t sequence_length = 1;
+                if (const auto *in = std::get_if<LLMPreprocessedInput>(&data[i])) {
+                    sequence_length = std::max<int64_t>(1, in->S);
+                }
+                result.rawOutputShape = config.output_shape.empty() ? default_output_shape(config.type, sequence_length) : config.output_shape;
+                result.rawOutput.assign(element_count(result.rawOutputShape), 0.0f);
+            }
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    SyntheticSubmitterStats get_stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+};
+
+#endif /* _SYNTHETIC_SUBMITTER_HPP_ */
@@ -0,0 +1,359 @@
+#include "thermal_telemetry.hpp"
+#include "thread_placement.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+bool read_first_line(const std::string &path, std::string &line)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+bool read_double(const std::string &path, double &value)
+{
+    std::string line;
+    if (!read_first_line(path, line)) return false;
+    try {
+        value = std::stod(line);
+        return true;
+    }
+    catch (const std::exception &) {
+        return false;
+    }
+}
+
+bool file_exists(const std::string &path)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(file);
+}
+
+// "cpu MHz : 2400.000" lines of /proc/cpuinfo (x86; absent on most arm64 kernels).
+std::vector<double> read_cpuinfo_mhz(const std::string &path)
+{
+    std::vector<double> mhz;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (0 != line.compare(0, 7, "cpu MHz")) continue;
+        size_t colon = line.find(':');
+        if (std::string::npos == colon) continue;
+        try {
+            mhz.push_back(std::stod(line.substr(colon + 1)));
+        }
+        catch (const std::exception &) {
+        }
+    }
+    return mhz;
+}
+
+double pearson(const std::vector<double> &x, const std::vector<double> &y)
+{
+    const size_t n = x.size();
+    if (n < 3) return 0;
+    double mx = 0, my = 0;
+    for (size_t i = 0; i < n; ++i) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxy = 0, sxx = 0, syy = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+        syy += (y[i] - my) * (y[i] - my);
+    }
+    return (sxx > 0 && syy > 0) ? sxy / std::sqrt(sxx * syy) : 0;
+}
+
+} // namespace
+
+SysfsTelemetrySource::SysfsTelemetrySource(const std::string &sys_root, const std::string &proc_root)
+    : proc_root(proc_root)
+{
+    const std::string cpu_root = sys_root + "/devices/system/cpu";
+    std::string online;
+    if (!read_first_line(cpu_root + "/online", online)) online = "0";
+    for (int cpu : CpuSet::parse(online).cpus) {
+        const std::string cpu_dir = cpu_root + "/cpu" + std::to_string(cpu);
+        if (file_exists(cpu_dir + "/cpufreq/scaling_cur_freq")) {
+            cur_freq_paths.push_back(cpu_dir + "/cpufreq/scaling_cur_freq");
+            hw_max_freq_paths.push_back(cpu_dir + "/cpufreq/cpuinfo_max_freq");
+            cap_freq_paths.push_back(cpu_dir + "/cpufreq/scaling_max_freq");
+        }
+        for (const char *counter : {"/thermal_throttle/core_throttle_count", "/thermal_throttle/package_throttle_count"}) {
+            if (file_exists(cpu_dir + counter)) throttle_paths.push_back(cpu_dir + counter);
+        }
+    }
+    for (int zone = 0; file_exists(sys_root + "/class/thermal/thermal_zone" + std::to_string(zone) + "/temp"); ++zone) {
+        temperature_paths.push_back(sys_root + "/class/thermal/thermal_zone" + std::to_string(zone) + "/temp");
+    }
+}
+
+TelemetrySample SysfsTelemetrySource::read()
+{
+    TelemetrySample sample;
+    std::vector<double> mhz;
+    double value = 0;
+    for (const auto &path : cur_freq_paths) {
+        if (read_double(path, value)) mhz.push_back(value / 1000.0);
+    }
+    if (mhz.empty()) mhz = read_cpuinfo_mhz(proc_root + "/cpuinfo");
+    if (!mhz.empty()) {
+        double sum = 0;
+        for (double m : mhz) sum += m;
+        sample.freq_mean_mhz = sum / mhz.size();
+        sample.freq_min_mhz = *std::min_element(mhz.begin(), mhz.end());
+    }
+    for (const auto &path : hw_max_freq_paths) {
+        if (read_double(path, value)) sample.freq_hw_max_mhz = std::max(sample.freq_hw_max_mhz, value / 1000.0);
+    }
+    for (const auto &path : cap_freq_paths) {
+        if (read_double(path, value) && (0 == sample.freq_cap_mhz || value / 1000.0 < sample.freq_cap_mhz)) {
+            sample.freq_cap_mhz = value / 1000.0;
+        }
+    }
+    for (const auto &path : temperature_paths) {
+        // Zones that are powered down report an error on read and are skipped.
+        if (read_double(path, value)) {
+            const double celsius = value / 1000.0;
+            if (!sample.has_temperature || celsius > sample.temperature_c) sample.temperature_c = celsius;
+            sample.has_temperature = true;
+        }
+    }
+    for (const auto &path : throttle_paths) {
+        if (read_double(path, value)) sample.throttle_count += static_cast<uint64_t>(value);
+    }
+    return sample;
+}
+
+TelemetrySampler::TelemetrySampler(std::shared_ptr<TelemetrySource> source, std::chrono::milliseconds interval)
+    : source(std::move(source)), interval(std::max(interval, std::chrono::milliseconds(1)))
+{
+}
+
+TelemetrySampler::~TelemetrySampler()
+{
+    stop();
+}
+
+void TelemetrySampler::sample_once()
+{
+    TelemetrySample sample = source->read();
+    std::lock_guard<std::mutex> lock(mutex);
+    sample.t = std::chrono::duration<double>(Clock::now() - start_time).count();
+    samples.push_back(sample);
+}
+
+void TelemetrySampler::worker_loop()
+{
+    auto next = Clock::now() + interval;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (cond_stop.wait_until(lock, next, [this] { return !running; })) return;
+        }
+        sample_once();
+        next += interval;
+    }
+}
+
+void TelemetrySampler::start()
+{
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        samples.clear();
+        start_time = Clock::now();
+        running = true;
+    }
+    sample_once();
+    worker = std::thread(&TelemetrySampler::worker_loop, this);
+}
+
+void TelemetrySampler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    cond_stop.notify_all();
+    worker.join();
+    sample_once();
+}
+
+TelemetrySampler::Clock::time_point TelemetrySampler::get_start_time() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return start_time;
+}
+
+std::vector<TelemetrySample> TelemetrySampler::get_samples() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples;
+}
+
+TelemetryReport correlate_telemetry(const std::vector<TelemetrySample> &samples, const std::vector<LatencyPoint> &latencies)
+{
+    TelemetryReport report;
+    if (samples.empty()) return report;
+    report.duration_s = samples.back().t;
+    report.min_freq_mhz = samples.front().freq_mean_mhz;
+    report.throttle_events = samples.back().throttle_count - std::min(samples.front().throttle_count, samples.back().throttle_count);
+
+    std::vector<LatencyPoint> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end(), [](const LatencyPoint &a, const LatencyPoint &b) { return a.t < b.t; });
+    size_t next = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const TelemetrySample &s = samples[i];
+        TelemetryWindow window;
+        window.sample = s;
+        double latency_sum = 0;
+        // Calls completed before the first sample belong to the first window.
+        while (next < sorted.size() && sorted[next].t <= s.t) {
+            window.calls++;
+            window.queries += sorted[next].queries;
+            latency_sum += sorted[next].latency_ms;
+            ++next;
+        }
+        const double span = i ? s.t - samples[i - 1].t : 0;
+        window.mean_latency_ms = window.calls ? latency_sum / window.calls : 0;
+        window.qps = span > 0 ? window.queries / span : 0;
+        report.windows.push_back(window);
+
+        report.peak_temperature_c = std::max(report.peak_temperature_c, s.temperature_c);
+        if (s.freq_mean_mhz > 0) {
+            report.min_freq_mhz = report.min_freq_mhz > 0 ? std::min(report.min_freq_mhz, s.freq_mean_mhz) : s.freq_mean_mhz;
+        }
+        report.freq_hw_max_mhz = std::max(report.freq_hw_max_mhz, s.freq_hw_max_mhz);
+        if (s.freq_cap_mhz > 0 && s.freq_hw_max_mhz > 0 && s.freq_cap_mhz < s.freq_hw_max_mhz) report.frequency_capped = true;
+    }
+    report.throttled = report.throttle_events > 0 || report.frequency_capped;
+
+    // Early and late throughput over the first and last 20% of the run.
+    auto qps_between = [&](double from, double to) {
+        size_t queries = 0;
+        for (const auto &p : sorted) {
+            if (p.t > from && p.t <= to) queries += p.queries;
+        }
+        return to > from ? queries / (to - from) : 0.0;
+    };
+    if (report.duration_s > 0) {
+        report.early_qps = qps_between(0, report.duration_s * 0.2);
+        report.late_qps = qps_between(report.duration_s * 0.8, report.duration_s);
+        if (report.early_qps > 0) report.throughput_drop = 1.0 - report.late_qps / report.early_qps;
+    }
+
+    std::vector<double> freq, latency;
+    for (const auto &w : report.windows) {
+        if (w.calls && w.sample.freq_mean_mhz > 0) {
+            freq.push_back(w.sample.freq_mean_mhz);
+            latency.push_back(w.mean_latency_ms);
+        }
+    }
+    report.freq_latency_correlation = pearson(freq, latency);
+    return report;
+}
+
+std::string telemetry_report_to_json(const TelemetryReport &report)
+{
+    std::ostringstream out;
+    out << "{\n  \"duration_s\": " << report.duration_s
+        << ",\n  \"early_qps\": " << report.early_qps
+        << ",\n  \"late_qps\": " << report.late_qps
+        << ",\n  \"throughput_drop\": " << report.throughput_drop
+        << ",\n  \"peak_temperature_c\": " << report.peak_temperature_c
+        << ",\n  \"min_freq_mhz\": " << report.min_freq_mhz
+        << ",\n  \"freq_hw_max_mhz\": " << report.freq_hw_max_mhz
+        << ",\n  \"throttle_events\": " << report.throttle_events
+        << ",\n  \"frequency_capped\": " << (report.frequency_capped ? "true" : "false")
+        << ",\n  \"throttled\": " << (report.throttled ? "true" : "false")
+        << ",\n  \"freq_latency_correlation\": " << report.freq_latency_correlation
+        << ",\n  \"timeline\": [";
+    for (size_t i = 0; i < report.windows.size(); ++i) {
+        const TelemetryWindow &w = report.windows[i];
+        out << (i ? "," : "") << "\n    {\"t\": " << w.sample.t
+            << ", \"freq_mean_mhz\": " << w.sample.freq_mean_mhz
+            << ", \"freq_min_mhz\": " << w.sample.freq_min_mhz
+            << ", \"freq_cap_mhz\": " << w.sample.freq_cap_mhz;
+        if (w.sample.has_temperature) out << ", \"temperature_c\": " << w.sample.temperature_c;
+        out << ", \"throttle_count\": " << w.sample.throttle_count
+            << ", \"calls\": " << w.calls
+            << ", \"queries\": " << w.queries
+            << ", \"mean_latency_ms\": " << w.mean_latency_ms
+            << ", \"qps\": " << w.qps << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+void print_telemetry_report(const TelemetryReport &report)
+{
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Thermal and frequency telemetry" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Duration:         " << report.duration_s << " s, " << report.windows.size() << " samples" << std::endl;
+    std::cout << "-I- Throughput:       first 20% " << report.early_qps << " q/s, last 20% " << report.late_qps
+              << " q/s (drop " << report.throughput_drop * 100 << "%)" << std::endl;
+    std::cout << "-I- Frequency:        lowest mean " << report.min_freq_mhz << " MHz, hardware max "
+              << report.freq_hw_max_mhz << " MHz" << std::endl;
+    std::cout << "-I- Temperature:      peak " << report.peak_temperature_c << " C" << std::endl;
+    std::cout << "-I- Throttling:       " << (report.throttled ? "DETECTED" : "none") << " (" << report.throttle_events
+              << " throttle events" << (report.frequency_capped ? ", frequency capped" : "") << ")" << std::endl;
+    std::cout << "-I- Freq vs latency:  r = " << report.freq_latency_correlation << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+Telemetry_Submitter_Implementation::Telemetry_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner,
+                                                                       std::string report_path,
+                                                                       std::chrono::milliseconds interval,
+                                                                       std::shared_ptr<TelemetrySource> source)
+    : inner(std::move(inner)), report_path(std::move(report_path)),
+      sampler(source ? std::move(source) : std::make_shared<SysfsTelemetrySource>(), interval)
+{
+}
+
+Telemetry_Submitter_Implementation::~Telemetry_Submitter_Implementation()
+{
+    if (!started) return;
+    sampler.stop();
+    TelemetryReport report = get_report();
+    print_telemetry_report(report);
+    if (!report_path.empty()) {
+        write_report(report_path);
+    }
+}
+
+void Telemetry_Submitter_Implementation::initialize(string modelPath)
+{
+    inner->initialize(modelPath);
+    std::lock_guard<std::mutex> lock(mutex);
+    latencies.clear();
+    sampler.start();
+    started = true;
+}
+
+TelemetryReport Telemetry_Submitter_Implementation::get_report()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return correlate_telemetry(sampler.get_samples(), latencies);
+}
+
+bool Telemetry_Submitter_Implementation::write_report(const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open telemetry report " << path << std::endl;
+        return false;
+    }
+    file << telemetry_report_to_json(get_report());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,204 @@
+#ifndef _THERMAL_TELEMETRY_HPP_
+#define _THERMAL_TELEMETRY_HPP_
+
+#include "ai_bmt_interface.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CPU frequency, temperature and throttling state at one point in time. Fields a platform does not
+// expose stay 0 (or false for has_temperature).
+struct TelemetrySample {
+    double t = 0;                       // seconds since the sampler started
+    double freq_mean_mhz = 0;           // mean current frequency over online CPUs
+    double freq_min_mhz = 0;            // slowest online CPU
+    double freq_hw_max_mhz = 0;         // highest hardware limit (cpuinfo_max_freq)
+    double freq_cap_mhz = 0;            // lowest policy limit (scaling_max_freq), lowered by thermal cooling devices
+    bool has_temperature = false;
+    double temperature_c = 0;           // hottest thermal zone
+    uint64_t throttle_count = 0;        // sum of the core and package thermal throttle counters (x86)
+};
+
+// Where samples come from. The sampler only calls read(), so tests and other platforms can plug in
+// their own source.
+class TelemetrySource
+{
+public:
+    virtual ~TelemetrySource() = default;
+    virtual TelemetrySample read() = 0;
+};
+
+// Linux source. `sys_root` and `proc_root` replace /sys and /proc, so a fake tree works as well:
+//   <sys_root>/devices/system/cpu/online
+//   <sys_root>/devices/system/cpu/cpuN/cpufreq/{scaling_cur_freq,cpuinfo_max_freq,scaling_max_freq}   (kHz)
+//   <sys_root>/devices/system/cpu/cpuN/thermal_throttle/{core,package}_throttle_count
+//   <sys_root>/class/thermal/thermal_zoneN/temp                                                     (millidegree C)
+//   <proc_root>/cpuinfo "cpu MHz" lines, used when cpufreq is absent (VMs, some containers)
+// The files are located once at construction; read() only opens known paths.
+class SysfsTelemetrySource : public TelemetrySource
+{
+private:
+    std::string proc_root;
+    std::vector<std::string> cur_freq_paths;
+    std::vector<std::string> hw_max_freq_paths;
+    std::vector<std::string> cap_freq_paths;
+    std::vector<std::string> temperature_paths;
+    std::vector<std::string> throttle_paths;
+
+public:
+    explicit SysfsTelemetrySource(const std::string &sys_root = "/sys", const std::string &proc_root = "/proc");
+    TelemetrySample read() override;
+};
+
+// Samples a source on a background thread at a fixed interval.
+class TelemetrySampler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    std::shared_ptr<TelemetrySource> source;
+    std::chrono::milliseconds interval;
+
+    mutable std::mutex mutex;
+    std::condition_variable cond_stop;
+    bool running = false;
+    Clock::time_point start_time;
+    std::vector<TelemetrySample> samples;
+    std::thread worker;
+
+    void sample_once();
+    void worker_loop();
+
+public:
+    TelemetrySampler(std::shared_ptr<TelemetrySource> source, std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    ~TelemetrySampler();
+
+    TelemetrySampler(const TelemetrySampler&) = delete;
+    TelemetrySampler& operator=(const TelemetrySampler&) = delete;
+
+    // Takes the first sample immediately; samples from a previous start() are discarded.
+    void start();
+    // Takes a final sample so the last partial interval is covered.
+    void stop();
+
+    Clock::time_point get_start_time() const;
+    std::chrono::milliseconds get_interval() const { return interval; }
+    std::vector<TelemetrySample> get_samples() const;
+};
+
+// Completion of one inferVision/inferLLM call on the sampler's timeline.
+struct LatencyPoint {
+    double t = 0;                       // seconds since the sampler started, at completion
+    double latency_ms = 0;
+    size_t queries = 0;
+};
+
+// Telemetry sample i joined with the calls that completed in (t[i-1], t[i]].
+struct TelemetryWindow {
+    TelemetrySample sample;
+    size_t calls = 0;
+    size_t queries = 0;
+    double mean_latency_ms = 0;         // per call
+    double qps = 0;
+};
+
+struct TelemetryReport {
+    std::vector<TelemetryWindow> windows;
+    double duration_s = 0;
+    double early_qps = 0;               // throughput over the first 20% of the run
+    double late_qps = 0;                // throughput over the last 20% of the run
+    double throughput_drop = 0;         // 1 - late / early
+    double peak_temperature_c = 0;
+    double min_freq_mhz = 0;            // lowest mean frequency seen
+    double freq_hw_max_mhz = 0;
+    uint64_t throttle_events = 0;       // throttle counter increase over the run
+    bool frequency_capped = false;      // scaling_max_freq fell below the hardware limit at some point
+    bool throttled = false;             // throttle counters rose or the frequency was capped
+    double freq_latency_correlation = 0; // Pearson r of window frequency vs window latency (negative: slower when throttled)
+};
+
+TelemetryReport correlate_telemetry(const std::vector<TelemetrySample> &samples, const std::vector<LatencyPoint> &latencies);
+std::string telemetry_report_to_json(const TelemetryReport &report);
+void print_telemetry_report(const TelemetryReport &report);
+
+// Wraps a submitter, samples telemetry from the end of initialize() until destruction and records every
+// inference call on the same timeline, e.g.
+//   auto monitored = std::make_shared<Telemetry_Submitter_Implementation>(
+//       std::make_shared<ImageClassification_Interface_Implementation>(), "telemetry_report.json");
+//
+// Passive-cooled units often lose throughput only after minutes of load: compare early_qps with
+// late_qps and the per-window frequency and temperature. The report is printed, and written as JSON to
+// `report_path` (if non-empty), when the wrapper is destroyed.
+class Telemetry_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    std::shared_ptr<AI_BMT_Interface> inner;
+    std::string report_path;
+    TelemetrySampler sampler;
+
+    std::mutex mutex;
+    bool started = false;
+    std::vector<LatencyPoint> latencies;
+
+    template <typename Fn>
+    auto timed(size_t queries, Fn &&fn) -> decltype(fn())
+    {
+        auto start = TelemetrySampler::Clock::now();
+        auto result = fn();
+        auto end = TelemetrySampler::Clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (started) {
+            LatencyPoint point;
+            point.t = std::chrono::duration<double>(end - sampler.get_start_time()).count();
+            point.latency_ms = std::chrono::duration<double, std::milli>(end - start).count();
+            point.queries = queries;
+            latencies.push_back(point);
+        }
+        return result;
+    }
+
+public:
+    // `source` defaults to SysfsTelemetrySource().
+    explicit Telemetry_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner,
+                                                std::string report_path = "",
+                                                std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+                                                std::shared_ptr<TelemetrySource> source = nullptr);
+    ~Telemetry_Submitter_Implementation() override;
+
+    virtual InterfaceType getInterfaceType() override { return inner->getInterfaceType(); }
+    virtual Optional_Data getOptionalData() override { return inner->getOptionalData(); }
+
+    virtual void initialize(string modelPath) override;
+
+    virtual VariantType preprocessVisionData(const string &imagePath) override
+    {
+        return inner->preprocessVisionData(imagePath);
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        return inner->preprocessLLMData(llmData);
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        return timed(data.size(), [&] { return inner->inferVision(data); });
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        return timed(data.size(), [&] { return inner->inferLLM(data); });
+    }
+
+    // Correlates the samples taken so far with the recorded calls.
+    TelemetryReport get_report();
+    bool write_report(const std::string &path);
+};
+
+#endif /* _THERMAL_TELEMETRY_HPP_ */
@@ -0,0 +1,214 @@
+#include "thread_placement.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool read_first_line(const std::string &path, std::string &line)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+size_t read_number(const std::string &path)
+{
+    std::string line;
+    if (!read_first_line(path, line)) return 0;
+    try {
+        return static_cast<size_t>(std::stoull(line));
+    }
+    catch (const std::exception &) {
+        return 0;
+    }
+}
+
+size_t page_size()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+} // namespace
+
+CpuSet CpuTopology::all() const
+{
+    CpuSet set;
+    for (const auto &cpu : cpus) set.cpus.push_back(cpu.id);
+    return set;
+}
+
+size_t CpuTopology::numa_node_count() const
+{
+    int max_node = -1;
+    for (const auto &cpu : cpus) max_node = std::max(max_node, cpu.numa_node);
+    return static_cast<size_t>(max_node + 1);
+}
+
+CpuSet CpuTopology::numa_node(int node) const
+{
+    CpuSet set;
+    for (const auto &cpu : cpus) {
+        if (cpu.numa_node == node) set.cpus.push_back(cpu.id);
+    }
+    return set;
+}
+
+CpuSet CpuTopology::performance_cores() const
+{
+    size_t max_capacity = 0;
+    for (const auto &cpu : cpus) max_capacity = std::max(max_capacity, cpu.capacity);
+    CpuSet set;
+    for (const auto &cpu : cpus) {
+        if (cpu.capacity == max_capacity) set.cpus.push_back(cpu.id);
+    }
+    return set;
+}
+
+CpuSet CpuTopology::efficiency_cores() const
+{
+    size_t max_capacity = 0;
+    for (const auto &cpu : cpus) max_capacity = std::max(max_capacity, cpu.capacity);
+    CpuSet set;
+    for (const auto &cpu : cpus) {
+        if (cpu.capacity < max_capacity) set.cpus.push_back(cpu.id);
+    }
+    return set;
+}
+
+int CpuTopology::node_of(int cpu) const
+{
+    for (const auto &info : cpus) {
+        if (info.id == cpu) return info.numa_node;
+    }
+    return -1;
+}
+
+CpuTopology detect_cpu_topology(const std::string &sysfs_root)
+{
+    CpuTopology topology;
+    std::string online;
+    CpuSet online_cpus;
+    if (read_first_line(sysfs_root + "/cpu/online", online)) {
+        online_cpus = CpuSet::parse(online);
+    } else {
+        const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < count; ++i) online_cpus.cpus.push_back(static_cast<int>(i));
+    }
+
+    for (int id : online_cpus.cpus) {
+        CpuInfo info;
+        info.id = id;
+        const std::string cpu_dir = sysfs_root + "/cpu/cpu" + std::to_string(id);
+        info.package = static_cast<int>(read_number(cpu_dir + "/topology/physical_package_id"));
+        // cpu_capacity is exported on arm64 hybrid systems; max frequency separates P/E cores elsewhere.
+        info.capacity = read_number(cpu_dir + "/cpu_capacity");
+        if (0 == info.capacity) info.capacity = read_number(cpu_dir + "/cpufreq/cpuinfo_max_freq");
+        topology.cpus.push_back(info);
+    }
+
+    std::string node_cpus;
+    for (int node = 0; read_first_line(sysfs_root + "/node/node" + std::to_string(node) + "/cpulist", node_cpus); ++node) {
+        CpuSet set = CpuSet::parse(node_cpus);
+        for (auto &info : topology.cpus) {
+            if (set.contains(info.id)) info.numa_node = node;
+        }
+    }
+    return topology;
+}
+
+ThreadPlacementPolicy make_node_local_placement(const CpuTopology &topology, int node)
+{
+    CpuSet node_cpus = topology.numa_node(node);
+    CpuSet fast, slow;
+    const CpuSet performance = topology.performance_cores();
+    for (int cpu : node_cpus.cpus) {
+        (performance.contains(cpu) ? fast : slow).cpus.push_back(cpu);
+    }
+
+    ThreadPlacementPolicy policy;
+    policy.inference = fast.empty() ? node_cpus : fast;
+    policy.preprocess = policy.inference;
+    policy.consumer = slow.empty() ? node_cpus : slow;
+    return policy;
+}
+
+ThreadPlacementPolicy placement_from_environment()
+{
+    auto read = [](const char *name) {
+        const char *value = std::getenv(name);
+        return value ? CpuSet::parse(value) : CpuSet();
+    };
+    ThreadPlacementPolicy policy;
+    if (const char *node = std::getenv("AI_BMT_NUMA_NODE")) {
+        policy = make_node_local_placement(detect_cpu_topology(), std::stoi(node));
+    }
+    for (auto stage : {std::make_pair(&policy.preprocess, "AI_BMT_PREPROCESS_CPUS"),
+                       std::make_pair(&policy.inference, "AI_BMT_INFERENCE_CPUS"),
+                       std::make_pair(&policy.consumer, "AI_BMT_CONSUMER_CPUS")}) {
+        if (std::getenv(stage.second)) *stage.first = read(stage.second);
+    }
+    return policy;
+}
+
+bool pin_current_thread(const CpuSet &cpus)
+{
+    if (cpus.empty()) return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus.cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (0 != rc) {
+        std::cerr << "Failed to pin thread to CPUs " << cpus.to_string() << " (error " << rc << ")" << std::endl;
+        return false;
+    }
+    return true;
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus.cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+    return 0 != mask && 0 != SetThreadAffinityMask(GetCurrentThread(), mask);
+#else
+    return false; // macOS only offers affinity hints (thread_policy_set), not placement
+#endif
+}
+
+int current_cpu()
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#else
+    return -1;
+#endif
+}
+
+void numa_first_touch(void *data, size_t size)
+{
+    volatile uint8_t *bytes = static_cast<volatile uint8_t *>(data);
+    const size_t step = page_size();
+    for (size_t offset = 0; offset < size; offset += step) {
+        bytes[offset] = 0;
+    }
+}
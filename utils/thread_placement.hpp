@@ -0,0 +1,136 @@
+#ifndef _THREAD_PLACEMENT_HPP_
+#define _THREAD_PLACEMENT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// A set of logical CPU ids, written in the Linux cpulist format ("0-3,8,10-11").
+// Parsing and formatting are header-only so the ORT examples can use them without linking utils/.
+struct CpuSet {
+    std::vector<int> cpus;  // sorted, unique
+
+    bool empty() const { return cpus.empty(); }
+    size_t size() const { return cpus.size(); }
+    bool contains(int cpu) const { return std::binary_search(cpus.begin(), cpus.end(), cpu); }
+
+    static CpuSet parse(const std::string &list)
+    {
+        CpuSet set;
+        size_t pos = 0;
+        while (pos < list.size()) {
+            size_t end = list.find(',', pos);
+            if (std::string::npos == end) end = list.size();
+            std::string item = list.substr(pos, end - pos);
+            item.erase(0, item.find_first_not_of(" \t\r\n"));
+            item.erase(item.find_last_not_of(" \t\r\n") + 1);
+            if (!item.empty()) {
+                size_t dash = item.find('-');
+                int first = std::stoi(item.substr(0, dash));
+                int last = (std::string::npos == dash) ? first : std::stoi(item.substr(dash + 1));
+                if (first < 0 || last < first) throw std::invalid_argument("Invalid CPU list: " + list);
+                for (int cpu = first; cpu <= last; ++cpu) set.cpus.push_back(cpu);
+            }
+            pos = end + 1;
+        }
+        std::sort(set.cpus.begin(), set.cpus.end());
+        set.cpus.erase(std::unique(set.cpus.begin(), set.cpus.end()), set.cpus.end());
+        return set;
+    }
+
+    std::string to_string() const
+    {
+        std::string out;
+        for (size_t i = 0; i < cpus.size();) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+            if (!out.empty()) out += ',';
+            out += std::to_string(cpus[i]);
+            if (j > i) out += '-' + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+        return out;
+    }
+
+    // Splits the set into `parts` contiguous groups of near-equal size (e.g. one group per shard).
+    std::vector<CpuSet> split(size_t parts) const
+    {
+        std::vector<CpuSet> groups(std::max<size_t>(1, parts));
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            groups[i * groups.size() / cpus.size()].cpus.push_back(cpus[i]);
+        }
+        return groups;
+    }
+};
+
+// Value for the ORT session config entry "session.intra_op_thread_affinities": one entry per
+// intra-op thread except the caller, separated by ';'. ORT numbers logical processors from 1.
+inline std::string ort_intra_op_affinities(const CpuSet &cpus, size_t intra_op_threads)
+{
+    std::string out;
+    for (size_t t = 1; t < intra_op_threads && !cpus.empty(); ++t) {
+        if (!out.empty()) out += ';';
+        out += std::to_string(cpus.cpus[t % cpus.size()] + 1);
+    }
+    return out;
+}
+
+struct CpuInfo {
+    int id = 0;
+    int numa_node = 0;
+    int package = 0;               // physical socket
+    size_t capacity = 0;           // relative performance (cpu_capacity, else max frequency); 0 if unknown
+};
+
+// Host CPU layout read from sysfs. On other platforms every online CPU is reported on node 0 with
+// unknown capacity, so the placement helpers degrade to plain core sets.
+struct CpuTopology {
+    std::vector<CpuInfo> cpus;
+
+    CpuSet all() const;
+    size_t numa_node_count() const;
+    CpuSet numa_node(int node) const;
+    // big.LITTLE: cores with the highest / lower capacity. Without capacity information every
+    // core counts as a performance core and efficiency_cores() is empty.
+    CpuSet performance_cores() const;
+    CpuSet efficiency_cores() const;
+    int node_of(int cpu) const;
+};
+
+// `sysfs_root` is the directory holding cpu/ and node/ (normally /sys/devices/system).
+CpuTopology detect_cpu_topology(const std::string &sysfs_root = "/sys/devices/system");
+
+// Which cores each pipeline stage may run on. Empty sets leave the stage unpinned.
+struct ThreadPlacementPolicy {
+    CpuSet preprocess;   // decode / preprocessing workers
+    CpuSet inference;    // threads that drive the model (ORT intra-op pool, CPU backend engines, shards)
+    CpuSet consumer;     // completion and queue-consumer threads (post-processing, result hand-off)
+
+    bool empty() const { return preprocess.empty() && inference.empty() && consumer.empty(); }
+};
+
+// Keeps every stage on one NUMA node. On hybrid CPUs inference and preprocessing get the
+// performance cores of that node and the consumers its efficiency cores.
+ThreadPlacementPolicy make_node_local_placement(const CpuTopology &topology, int node = 0);
+
+// Reads AI_BMT_PREPROCESS_CPUS, AI_BMT_INFERENCE_CPUS and AI_BMT_CONSUMER_CPUS (cpulist format).
+// With AI_BMT_NUMA_NODE=<node> the stages without their own list get make_node_local_placement(..)
+// of that node.
+ThreadPlacementPolicy placement_from_environment();
+
+// Pins the calling thread. Returns false when the set is empty, the platform has no affinity API
+// (macOS) or the call was refused; the thread then keeps floating.
+bool pin_current_thread(const CpuSet &cpus);
+
+// Logical CPU the calling thread is running on, or -1 when unknown.
+int current_cpu();
+
+// Writes one byte per page so that, under the default first-touch policy, the pages are
+// allocated on the NUMA node of the calling thread. Call it from the pinned consumer before the
+// buffer is first used (mmap'ed buffers from page_aligned_alloc are not backed until touched).
+void numa_first_touch(void *data, size_t size);
+
+#endif /* _THREAD_PLACEMENT_HPP_ */
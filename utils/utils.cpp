@@ -340,33 +340,48 @@ void draw_single_bbox(cv::Mat& frame, const NamedBbox& named_bbox, const cv::Sca
     draw_label(frame, label, bbox_rect.tl(), color);
 }
 
+static const cv::Scalar &get_class_color(size_t class_id) {
+    // Built once; the lookup is on the per-frame drawing path.
+    static const std::unordered_map<int, cv::Scalar> class_colors = [] {
+        std::unordered_map<int, cv::Scalar> colors;
+        initialize_class_colors(colors);
+        return colors;
+    }();
+    auto it = class_colors.find(static_cast<int>(class_id));
+    return (it != class_colors.end()) ? it->second : COLORS[class_id % COLORS.size()];
+}
+
 void draw_bounding_boxes(cv::Mat& frame, const std::vector<NamedBbox>& bboxes) {
-    std::unordered_map<int, cv::Scalar> class_colors;
-    initialize_class_colors(class_colors);
     for (const auto& named_bbox : bboxes) {
-        const auto& color = class_colors[named_bbox.class_id];
-        draw_single_bbox(frame, named_bbox, color);
+        draw_single_bbox(frame, named_bbox, get_class_color(named_bbox.class_id));
     }
 }
 
-std::vector<NamedBbox> parse_nms_data(uint8_t* data, size_t max_class_count) {
-    std::vector<NamedBbox> bboxes;
-    size_t offset = 0;
+void draw_bounding_boxes(cv::Mat& frame, const NmsDetections& detections) {
+    for (size_t i = 0; i < detections.count; i++) {
+        NamedBbox named_bbox;
+        named_bbox.bbox = {detections.y_min[i], detections.x_min[i], detections.y_max[i], detections.x_max[i], detections.score[i]};
+        named_bbox.class_id = detections.class_id[i] + 1;
+        draw_single_bbox(frame, named_bbox, get_class_color(named_bbox.class_id));
+    }
+}
 
-    for (size_t class_id = 0; class_id < max_class_count; class_id++) {
-        auto det_count = static_cast<uint32_t>(*reinterpret_cast<float32_t*>(data + offset));
-        offset += sizeof(float32_t);
+std::vector<NamedBbox> parse_nms_data(uint8_t* data, size_t max_class_count) {
+    static_assert(sizeof(NmsBox) == sizeof(hailo_bbox_float32_t), "NmsBox must match hailo_bbox_float32_t");
 
-        for (size_t j = 0; j < det_count; j++) {
-            hailo_bbox_float32_t bbox_data = *reinterpret_cast<hailo_bbox_float32_t*>(data + offset);
-            offset += sizeof(hailo_bbox_float32_t);
+    size_t total = 0;
+    for_each_nms_box(data, std::numeric_limits<size_t>::max(), max_class_count,
+                     [&total](size_t, const NmsBox &) { total++; });
 
-            NamedBbox named_bbox;
-            named_bbox.bbox = bbox_data;
-            named_bbox.class_id = class_id + 1;
-            bboxes.push_back(named_bbox);
-        }
-    }
+    std::vector<NamedBbox> bboxes;
+    bboxes.reserve(total);
+    for_each_nms_box(data, std::numeric_limits<size_t>::max(), max_class_count,
+                     [&bboxes](size_t class_id, const NmsBox &box) {
+        NamedBbox named_bbox;
+        named_bbox.bbox = {box.y_min, box.x_min, box.y_max, box.x_max, box.score};
+        named_bbox.class_id = class_id + 1;
+        bboxes.push_back(named_bbox);
+    });
     return bboxes;
 }
 
@@ -43,6 +43,8 @@
 #include "hailo/infer_model.hpp" 
 #include "hailo/hailort.h"
 
+#include "nms_decoder.hpp"
+
 
 
 
@@ -73,7 +75,9 @@ struct PreprocessedFrameItem {
 struct InferenceOutputItem {
     size_t frame_idx;  
     std::vector<std::pair<uint8_t*, hailo_vstream_info_t>> output_data_and_infos;
-    
+    // Owns the buffers behind output_data_and_infos, so they stay valid until the consumer drops the item.
+    std::vector<std::shared_ptr<uint8_t>> output_guards;
+    hailo_status status = HAILO_SUCCESS;
 };
 
 struct NamedBbox {
@@ -141,6 +145,7 @@ cv::Rect get_bbox_coordinates(const hailo_bbox_float32_t &bbox, int frame_width,
 void draw_label(cv::Mat &frame, const std::string &label, const cv::Point &top_left, const cv::Scalar &color);
 void draw_single_bbox(cv::Mat &frame, const NamedBbox &named_bbox, const cv::Scalar &color);
 void draw_bounding_boxes(cv::Mat &frame, const std::vector<NamedBbox> &bboxes);
+void draw_bounding_boxes(cv::Mat &frame, const NmsDetections &detections);
 std::vector<NamedBbox> parse_nms_data(uint8_t *data, size_t max_class_count);
 
 // ─────────────────────────────────────────────────────────────────────────────
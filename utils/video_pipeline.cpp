@@ -0,0 +1,257 @@
+#include "video_pipeline.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// frame_idx of the marker the infer stage pushes after its last submission.
+constexpr size_t END_OF_STREAM = std::numeric_limits<size_t>::max();
+
+struct DecodedFrame {
+    size_t frame_idx;
+    Clock::time_point decode_start;
+    cv::Mat frame;
+    std::shared_ptr<std::vector<uint8_t>> input;
+};
+
+struct FrameRecord {
+    Clock::time_point decode_start;
+    cv::Mat frame;
+};
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+void default_preprocess(int width, int height, const cv::Mat &frame, std::vector<uint8_t> &input)
+{
+    cv::Mat resized;
+    cv::resize(frame, resized, cv::Size(width, height), 0, 0, cv::INTER_LINEAR);
+    cv::cvtColor(resized, resized, cv::COLOR_BGR2RGB);
+    input.assign(resized.data, resized.data + resized.total() * resized.elemSize());
+}
+
+} // namespace
+
+VideoPipelineReport run_video_pipeline(const std::string &input_path,
+                                       std::shared_ptr<InferBackend> backend,
+                                       VideoPipelineConfig config)
+{
+    cv::VideoCapture capture;
+    double org_height = 0;
+    double org_width = 0;
+    size_t frame_count = 0;
+    InputType input_type = determine_input_type(input_path, capture, org_height, org_width, frame_count);
+    if (!input_type.is_video && !input_type.is_camera) {
+        throw std::invalid_argument("run_video_pipeline expects a video file or a camera, got " + input_path);
+    }
+    if (config.max_frames && (0 == frame_count || config.max_frames < frame_count)) {
+        frame_count = config.max_frames;
+    }
+
+    cv::VideoWriter video;
+    if (!config.output_path.empty()) {
+        double fps = capture.get(cv::CAP_PROP_FPS);
+        init_video_writer(config.output_path, video, fps > 0 ? fps : 30.0,
+                          static_cast<int>(org_width), static_cast<int>(org_height));
+    }
+
+    FramePreprocessFn preprocess = config.preprocess;
+    if (!preprocess) {
+        preprocess = [&config](const cv::Mat &frame, std::vector<uint8_t> &input) {
+            default_preprocess(config.input_width, config.input_height, frame, input);
+        };
+    }
+
+    if (config.placement.empty()) {
+        config.placement = placement_from_environment();
+    }
+
+    BoundedTSQueue<DecodedFrame> decoded_queue(config.queue_depth);
+    auto output_queue = std::make_shared<BoundedTSQueue<AsyncOutputItem>>(config.max_in_flight + 1);
+    AsyncInferPipeline pipeline(backend,
+                                [output_queue](AsyncOutputItem &&item) { output_queue->push(std::move(item)); },
+                                config.max_in_flight, config.placement.consumer);
+
+    // Original frames wait here while their input is on the device.
+    std::mutex frames_mutex;
+    std::unordered_map<size_t, FrameRecord> frames_in_flight;
+
+    std::atomic<bool> stop_requested{false};
+    std::atomic<size_t> frames_submitted{0};
+    VideoPipelineReport report;
+    std::vector<double> latencies_ms;
+
+    auto start = Clock::now();
+
+    auto decode_stage = [&]() -> hailo_status {
+        pin_current_thread(config.placement.preprocess);
+        hailo_status status = HAILO_SUCCESS;
+        try {
+            for (size_t frame_idx = 0; !stop_requested; ++frame_idx) {
+                if (config.max_frames && frame_idx >= config.max_frames) break;
+
+                auto work_start = Clock::now();
+                DecodedFrame item;
+                item.frame_idx = frame_idx;
+                item.decode_start = work_start;
+                if (!capture.read(item.frame) || item.frame.empty()) break;
+                // Allocated and written here, so the input lands on the decode thread's NUMA node.
+                item.input = std::make_shared<std::vector<uint8_t>>();
+                preprocess(item.frame, *item.input);
+                report.decode.busy_seconds += seconds_since(work_start);
+                report.frames_decoded++;
+
+                if (config.drop_frames) {
+                    if (!decoded_queue.try_push(std::move(item))) report.frames_dropped++;
+                } else {
+                    decoded_queue.push(std::move(item));
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Decode stage failed: " << e.what() << std::endl;
+            status = HAILO_INTERNAL_FAILURE;
+        }
+        decoded_queue.stop(); // pop() returns false once the remaining frames are drained
+        capture.release();
+        return status;
+    };
+
+    auto infer_stage = [&]() -> hailo_status {
+        pin_current_thread(config.placement.inference);
+        hailo_status status = HAILO_SUCCESS;
+        size_t refused = 0;
+        try {
+            DecodedFrame item;
+            while (decoded_queue.pop(item)) {
+                // Includes time blocked on max_in_flight, i.e. waiting for the device.
+                auto work_start = Clock::now();
+                {
+                    std::lock_guard<std::mutex> lock(frames_mutex);
+                    frames_in_flight[item.frame_idx] = {item.decode_start, item.frame};
+                }
+                if (BackendStatus::Success == pipeline.infer(item.input, item.frame_idx)) {
+                    frames_submitted++;
+                } else {
+                    std::lock_guard<std::mutex> lock(frames_mutex);
+                    frames_in_flight.erase(item.frame_idx);
+                    refused++;
+                }
+                report.infer.busy_seconds += seconds_since(work_start);
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Infer stage failed: " << e.what() << std::endl;
+            decoded_queue.stop();
+            status = HAILO_INTERNAL_FAILURE;
+        }
+        report.frames_dropped += refused;
+        AsyncOutputItem end_of_stream;
+        end_of_stream.frame_idx = END_OF_STREAM;
+        output_queue->push(std::move(end_of_stream));
+        return status;
+    };
+
+    auto post_stage = [&]() -> hailo_status {
+        pin_current_thread(config.placement.consumer);
+        hailo_status status = HAILO_SUCCESS;
+        try {
+            bool end_seen = false;
+            size_t received = 0;
+            AsyncOutputItem output;
+            while (!(end_seen && received == frames_submitted) && output_queue->pop(output)) {
+                if (END_OF_STREAM == output.frame_idx) {
+                    end_seen = true;
+                    continue;
+                }
+                received++;
+
+                auto work_start = Clock::now();
+                FrameRecord record;
+                {
+                    std::lock_guard<std::mutex> lock(frames_mutex);
+                    auto it = frames_in_flight.find(output.frame_idx);
+                    if (it == frames_in_flight.end()) continue;
+                    record = std::move(it->second);
+                    frames_in_flight.erase(it);
+                }
+                if (output.success) {
+                    if (config.annotate) config.annotate(record.frame, output);
+                    report.frames_completed++;
+                }
+                if (video.isOpened()) video.write(record.frame);
+                if (!show_frame(input_type, record.frame)) stop_requested = true;
+                show_progress(input_type, static_cast<int>(received - 1), frame_count);
+                report.post.busy_seconds += seconds_since(work_start);
+
+                latencies_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - record.decode_start).count());
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Post-process stage failed: " << e.what() << std::endl;
+            stop_requested = true;
+            output_queue->stop();
+            status = HAILO_INTERNAL_FAILURE;
+        }
+        return status;
+    };
+
+    auto decode_future = std::async(std::launch::async, decode_stage);
+    auto infer_future = std::async(std::launch::async, infer_stage);
+    auto post_future = std::async(std::launch::async, post_stage);
+    hailo_status status = wait_and_check_threads(decode_future, "Decode", infer_future, "Infer", post_future, "Post-process");
+    if (HAILO_SUCCESS != status) {
+        throw std::runtime_error("Video pipeline failed");
+    }
+    video.release();
+
+    report.wall_seconds = seconds_since(start);
+    report.sustained_fps = report.wall_seconds > 0 ? report.frames_completed / report.wall_seconds : 0;
+    for (StageOccupancy *stage : {&report.decode, &report.infer, &report.post}) {
+        stage->occupancy = report.wall_seconds > 0 ? stage->busy_seconds / report.wall_seconds : 0;
+    }
+    if (!latencies_ms.empty()) {
+        report.latency_mean_ms = std::accumulate(latencies_ms.begin(), latencies_ms.end(), 0.0) / latencies_ms.size();
+        report.latency_p50_ms = percentile(latencies_ms, 50);
+        report.latency_p90_ms = percentile(latencies_ms, 90);
+        report.latency_p99_ms = percentile(latencies_ms, 99);
+    }
+    report.infer_stats = pipeline.get_stats();
+    return report;
+}
+
+void print_video_pipeline_report(const VideoPipelineReport &report)
+{
+    std::cout << BOLDGREEN << "\n-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Video pipeline (decode -> infer -> post-process)" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Frames:           " << report.frames_completed << " completed, "
+              << report.frames_dropped << " dropped, " << report.frames_decoded << " decoded" << std::endl;
+    std::cout << "-I- Sustained FPS:    " << report.sustained_fps << std::endl;
+    std::cout << "-I- Total time:       " << report.wall_seconds << " sec" << std::endl;
+    std::cout << "-I- Occupancy:        decode " << report.decode.occupancy * 100
+              << "%, infer " << report.infer.occupancy * 100
+              << "%, post " << report.post.occupancy * 100 << "%" << std::endl;
+    std::cout << "-I- E2E latency:      mean " << report.latency_mean_ms << " ms, p50 " << report.latency_p50_ms
+              << " ms, p90 " << report.latency_p90_ms << " ms, p99 " << report.latency_p99_ms << " ms" << std::endl;
+    std::cout << "-I- Device jobs:      " << report.infer_stats.completed << " completed, "
+              << report.infer_stats.failed << " failed, " << report.infer_stats.timeouts << " timeouts, peak in flight "
+              << report.infer_stats.peak_in_flight << std::endl;
+    std::cout << "-I-----------------------------------------------" << RESET << std::endl;
+}
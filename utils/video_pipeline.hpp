@@ -0,0 +1,62 @@
+#ifndef _VIDEO_PIPELINE_HPP_
+#define _VIDEO_PIPELINE_HPP_
+
+#include "utils.hpp"
+#include "bounded_queue.hpp"
+#include "async_pipeline.hpp"
+#include "thread_placement.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Converts a decoded BGR frame into the model input buffer.
+using FramePreprocessFn = std::function<void(const cv::Mat &frame, std::vector<uint8_t> &input)>;
+// Draws the model outputs onto the original frame before it is encoded.
+using FrameAnnotateFn = std::function<void(cv::Mat &frame, const AsyncOutputItem &output)>;
+
+struct VideoPipelineConfig {
+    int input_width = 640;           // model input size used by the default preprocess
+    int input_height = 640;
+    size_t queue_depth = 8;          // capacity of the decode -> infer queue
+    size_t max_in_flight = AsyncInferPipeline::DEFAULT_MAX_IN_FLIGHT;
+    bool drop_frames = false;        // drop decoded frames instead of stalling the decoder when inference falls behind
+    size_t max_frames = 0;           // 0 = until the stream ends (or 'q' on a camera)
+    std::string output_path;         // annotated video is written here when non-empty
+    FramePreprocessFn preprocess;    // default: resize to input_width x input_height, BGR -> RGB, uint8 HWC
+    FrameAnnotateFn annotate;        // default: frame is encoded unchanged
+    ThreadPlacementPolicy placement; // decode runs on `preprocess`, infer on `inference`, post-process on `consumer`;
+                                     // empty = placement_from_environment(). Output buffers are first-touched on `consumer`.
+};
+
+struct StageOccupancy {
+    double busy_seconds = 0;         // time spent working (excludes blocking on queues)
+    double occupancy = 0;            // busy_seconds / wall time
+};
+
+struct VideoPipelineReport {
+    size_t frames_decoded = 0;
+    size_t frames_dropped = 0;       // dropped by the overload policy or refused by the backend
+    size_t frames_completed = 0;
+    double wall_seconds = 0;
+    double sustained_fps = 0;        // completed frames / wall time
+    StageOccupancy decode;
+    StageOccupancy infer;
+    StageOccupancy post;
+    double latency_mean_ms = 0;      // decode start -> annotated frame encoded
+    double latency_p50_ms = 0;
+    double latency_p90_ms = 0;
+    double latency_p99_ms = 0;
+    AsyncInferStats infer_stats;
+};
+
+// Runs decode -> infer -> annotate/encode as three concurrent stages over bounded queues.
+// `input_path` is a video file or camera (see determine_input_type).
+VideoPipelineReport run_video_pipeline(const std::string &input_path,
+                                       std::shared_ptr<InferBackend> backend,
+                                       VideoPipelineConfig config);
+
+void print_video_pipeline_report(const VideoPipelineReport &report);
+
+#endif /* _VIDEO_PIPELINE_HPP_ */
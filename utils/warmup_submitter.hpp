@@ -0,0 +1,327 @@
+#ifndef _WARMUP_SUBMITTER_HPP_
+#define _WARMUP_SUBMITTER_HPP_
+
+#include "ai_bmt_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <string>
+#include <variant>
+#include <vector>
+
+struct WarmupConfig {
+    size_t window = 5;                        // iterations in the rolling coefficient of variation
+    double cv_threshold = 0.05;               // steady state: stddev / mean of the window below this
+    size_t max_iterations = 100;              // give up (and report not converged) after this many replays
+    std::chrono::milliseconds max_duration{30000};
+    double cold_start_flag_ratio = 0.8;       // flag when cold throughput < ratio * warm throughput of the same batch
+    size_t batch_size = 1;                    // queries per warm-up replay
+    std::vector<std::string> image_paths;     // vision: sample images to preprocess; empty = a synthetic image
+    size_t sequence_length = 128;             // LLM: tokens of the synthetic query
+};
+
+struct WarmupReport {
+    bool ran = false;
+    bool converged = false;
+    size_t iterations = 0;                    // warm-up replays (their results are discarded)
+    size_t batch_size = 0;                    // queries per replay
+    double first_latency_ms = 0;              // the cold call
+    double warmup_mean_ms = 0;                // mean latency over all replays
+    double final_cv = 0;                      // rolling CV when warm-up stopped
+    double cold_qps = 0;                      // queries/s of the first call
+    double warm_qps = 0;                      // queries/s of the same batch over the last window of replays
+    double steady_qps = 0;                    // queries/s over the driver's measured calls (its own batch sizes)
+    size_t measured_calls = 0;
+    size_t measured_queries = 0;
+    double measured_seconds = 0;
+    bool cold_start_flagged = false;          // cold_qps < cold_start_flag_ratio * warm_qps
+};
+
+inline void print_warmup_report(const WarmupReport &report)
+{
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    std::cout << "-I- Warm-up" << std::endl;
+    std::cout << "-I-----------------------------------------------" << std::endl;
+    if (!report.ran) {
+        std::cout << "-I- Skipped (no replayable warm-up batch could be built)" << std::endl;
+        std::cout << "-I-----------------------------------------------" << std::endl;
+        return;
+    }
+    std::cout << "-I- Replays:          " << report.iterations << " x " << report.batch_size << " queries, "
+              << (report.converged ? "steady state reached" : "NOT converged") << " (CV " << report.final_cv * 100 << "%)" << std::endl;
+    std::cout << "-I- Latency:          first " << report.first_latency_ms << " ms, warm-up mean " << report.warmup_mean_ms << " ms" << std::endl;
+    std::cout << "-I- Throughput:       cold " << report.cold_qps << " q/s, warm " << report.warm_qps << " q/s (warm-up batch), "
+              << "steady " << report.steady_qps << " q/s (" << report.measured_queries << " queries in "
+              << report.measured_calls << " calls)" << std::endl;
+    if (report.cold_start_flagged) {
+        std::cout << "-I- Cold start:       first call ran at " << (report.warm_qps > 0 ? report.cold_qps / report.warm_qps * 100 : 0)
+                  << "% of the warm throughput of the same batch" << std::endl;
+    }
+    std::cout << "-I-----------------------------------------------" << std::endl;
+}
+
+// Runs a warm-up phase at the end of initialize(), before the driver issues its first timed call: a
+// batch is built with the inner submitter's own preprocessing (from `image_paths`, or a synthetic
+// image of the task's input size for vision, and a synthetic token sequence for LLM tasks) and
+// replayed (results discarded) until the rolling coefficient of variation of its latency drops below
+// the threshold. One-time costs (lazy allocations, weight prepacking, cache population) are thus paid
+// before the driver's timer sees a result. Warm-up statistics and the cold-start vs steady-state
+// throughput are kept separately and printed when the wrapper is destroyed. The cold start is judged
+// against the warm replays of the same batch, since the driver's calls may use another batch size.
+//
+// Only batches made of owning values (vectors, LLMPreprocessedInput) are replayed. Raw pointer and
+// Python object queries may transfer ownership to the submitter, so warm-up is skipped for them.
+class Warmup_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::shared_ptr<AI_BMT_Interface> inner;
+    WarmupConfig config;
+    std::mutex mutex;
+    bool initialized = false;
+    WarmupReport report;
+
+    static bool is_vision(InterfaceType type)
+    {
+        return type <= InterfaceType::SemanticSegmentation_CustomDataset;
+    }
+
+    // Input size the task's preprocessing expects (classification and segmentation require it exactly).
+    static int synthetic_image_size(InterfaceType type)
+    {
+        switch (type) {
+            case InterfaceType::ObjectDetection:
+            case InterfaceType::ObjectDetection_CustomDataset: return 640;
+            case InterfaceType::SemanticSegmentation:
+            case InterfaceType::SemanticSegmentation_CustomDataset: return 520;
+            default: return 224;
+        }
+    }
+
+    // Writes a size x size 24-bit BMP of pseudo-random pixels, which every image loader reads.
+    static bool write_synthetic_image(const std::string &path, int size)
+    {
+        const uint32_t row_bytes = (static_cast<uint32_t>(size) * 3 + 3) & ~3u;
+        const uint32_t pixel_bytes = row_bytes * static_cast<uint32_t>(size);
+        uint8_t header[54] = {'B', 'M'};
+        auto put32 = [&](size_t offset, uint32_t value) {
+            for (int i = 0; i < 4; ++i) header[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+        };
+        put32(2, 54 + pixel_bytes);     // file size
+        put32(10, 54);                  // pixel data offset
+        put32(14, 40);                  // BITMAPINFOHEADER
+        put32(18, static_cast<uint32_t>(size));
+        put32(22, static_cast<uint32_t>(size));
+        header[26] = 1;                 // planes
+        header[28] = 24;                // bits per pixel
+        put32(34, pixel_bytes);
+
+        std::vector<uint8_t> pixels(pixel_bytes, 0);
+        uint32_t state = 2463534242u;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size * 3; ++x) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                pixels[static_cast<size_t>(y) * row_bytes + x] = static_cast<uint8_t>(state);
+            }
+        }
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        return static_cast<bool>(file);
+    }
+
+    // One warm-up batch of `config.batch_size` queries, preprocessed by the inner submitter.
+    std::vector<VariantType> build_warmup_batch()
+    {
+        const InterfaceType type = inner->getInterfaceType();
+        const size_t batch_size = std::max<size_t>(1, config.batch_size);
+        std::vector<VariantType> batch;
+        if (is_vision(type)) {
+            std::vector<std::string> paths = config.image_paths;
+            std::string synthetic;
+            if (paths.empty()) {
+                synthetic = (std::filesystem::temp_directory_path() /
+                             ("ai_bmt_warmup_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + ".bmp")).string();
+                if (!write_synthetic_image(synthetic, synthetic_image_size(type))) return {};
+                paths.push_back(synthetic);
+            }
+            try {
+                for (size_t i = 0; i < batch_size; ++i) batch.push_back(inner->preprocessVisionData(paths[i % paths.size()]));
+            }
+            catch (const std::exception &e) {
+                std::cerr << "Warm-up skipped, preprocessing the warm-up image failed: " << e.what() << std::endl;
+                batch.clear();
+            }
+            if (!synthetic.empty()) {
+                std::error_code ec;
+                std::filesystem::remove(synthetic, ec);
+            }
+        } else {
+            // [CLS] tokens [SEP] with ids well inside every vocabulary the BMT uses.
+            const size_t length = std::max<size_t>(2, config.sequence_length);
+            LLMPreprocessedInput query;
+            query.input_ids.resize(length);
+            for (size_t t = 0; t < length; ++t) query.input_ids[t] = 1000 + static_cast<int64_t>(t % 1000);
+            query.input_ids.front() = 101;
+            query.input_ids.back() = 102;
+            query.attention_mask.assign(length, 1);
+            query.token_type_ids.assign(length, 0);
+            query.N = 1;
+            query.S = static_cast<int64_t>(length);
+            try {
+                for (size_t i = 0; i < batch_size; ++i) batch.push_back(inner->preprocessLLMData(query));
+            }
+            catch (const std::exception &e) {
+                std::cerr << "Warm-up skipped, preprocessing the warm-up query failed: " << e.what() << std::endl;
+                batch.clear();
+            }
+        }
+        return batch;
+    }
+
+    static bool is_replayable(const std::vector<VariantType> &data)
+    {
+        return !data.empty() && std::all_of(data.begin(), data.end(), [](const VariantType &query) {
+            return std::visit([](const auto &value) { return !std::is_pointer<std::decay_t<decltype(value)>>::value; }, query);
+        });
+    }
+
+    static double coefficient_of_variation(const std::deque<double> &values)
+    {
+        double mean = 0;
+        for (double v : values) mean += v;
+        mean /= values.size();
+        double var = 0;
+        for (double v : values) var += (v - mean) * (v - mean);
+        var /= values.size();
+        return mean > 0 ? std::sqrt(var) / mean : 0;
+    }
+
+    template <typename InferFn>
+    void warm_up(const std::vector<VariantType> &data, InferFn infer_fn)
+    {
+        report.ran = true;
+        report.batch_size = data.size();
+        std::deque<double> window;
+        double total_ms = 0;
+        auto start = Clock::now();
+        while (report.iterations < std::max<size_t>(1, config.max_iterations)) {
+            auto call_start = Clock::now();
+            infer_fn(data);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - call_start).count();
+            if (0 == report.iterations++) {
+                report.first_latency_ms = ms;
+                report.cold_qps = ms > 0 ? data.size() * 1000.0 / ms : 0;
+            }
+            total_ms += ms;
+            window.push_back(ms);
+            if (window.size() > config.window) window.pop_front();
+            if (window.size() == config.window) {
+                report.final_cv = coefficient_of_variation(window);
+                if (report.final_cv < config.cv_threshold) {
+                    report.converged = true;
+                    break;
+                }
+            }
+            if (Clock::now() - start > config.max_duration) break;
+        }
+        report.warmup_mean_ms = total_ms / report.iterations;
+        double window_ms = 0;
+        for (double ms : window) window_ms += ms;
+        window_ms /= window.size();
+        report.warm_qps = window_ms > 0 ? data.size() * 1000.0 / window_ms : 0;
+        report.cold_start_flagged = report.cold_qps < config.cold_start_flag_ratio * report.warm_qps;
+    }
+
+    template <typename Result, typename InferFn>
+    std::vector<Result> measured(const std::vector<VariantType> &data, InferFn infer_fn)
+    {
+        auto start = Clock::now();
+        std::vector<Result> results = infer_fn(data);
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        report.measured_calls++;
+        report.measured_queries += data.size();
+        report.measured_seconds += elapsed.count();
+        report.steady_qps = report.measured_seconds > 0 ? report.measured_queries / report.measured_seconds : 0;
+        return results;
+    }
+
+public:
+    explicit Warmup_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner,
+                                             WarmupConfig config = WarmupConfig())
+        : inner(std::move(inner)), config(config)
+    {
+        this->config.window = std::max<size_t>(2, this->config.window);
+    }
+
+    ~Warmup_Submitter_Implementation() override
+    {
+        if (initialized) print_warmup_report(report);
+    }
+
+    virtual InterfaceType getInterfaceType() override { return inner->getInterfaceType(); }
+    virtual Optional_Data getOptionalData() override { return inner->getOptionalData(); }
+
+    virtual void initialize(string modelPath) override
+    {
+        inner->initialize(modelPath);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        initialized = true;
+        report = WarmupReport();
+        const std::vector<VariantType> batch = build_warmup_batch();
+        if (!is_replayable(batch)) return;
+        try {
+            if (is_vision(inner->getInterfaceType())) {
+                warm_up(batch, [this](const std::vector<VariantType> &data) { return inner->inferVision(data); });
+            } else {
+                warm_up(batch, [this](const std::vector<VariantType> &data) { return inner->inferLLM(data); });
+            }
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Warm-up stopped after " << report.iterations << " replays: " << e.what() << std::endl;
+        }
+    }
+
+    virtual VariantType preprocessVisionData(const string &imagePath) override
+    {
+        return inner->preprocessVisionData(imagePath);
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        return inner->preprocessLLMData(llmData);
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        return measured<BMTVisionResult>(data, [this](const std::vector<VariantType> &batch) { return inner->inferVision(batch); });
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        return measured<BMTLLMResult>(data, [this](const std::vector<VariantType> &batch) { return inner->inferLLM(batch); });
+    }
+
+    WarmupReport get_report()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return report;
+    }
+};
+
+#endif /* _WARMUP_SUBMITTER_HPP_ */
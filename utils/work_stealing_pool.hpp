@@ -0,0 +1,333 @@
+#ifndef _WORK_STEALING_POOL_HPP_
+#define _WORK_STEALING_POOL_HPP_
+
+#include "ai_bmt_interface.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class TaskPriority {
+    High,       // e.g. cheap classification queries that should not wait behind segmentation
+    Normal,
+    Low,
+    Count
+};
+
+// Scheduling hints for one task. A task with a deadline is run earliest-deadline-first ahead of
+// every priority level; a deadline that has already passed when the task starts counts as a miss.
+struct TaskHints {
+    TaskPriority priority = TaskPriority::Normal;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    bool has_deadline() const { return deadline != std::chrono::steady_clock::time_point::max(); }
+};
+
+struct WorkStealingStats {
+    size_t executed = 0;
+    size_t stolen = 0;              // tasks a worker took from another worker's deque
+    size_t deadline_tasks = 0;
+    size_t deadline_misses = 0;     // deadline tasks that started after their deadline
+    std::vector<size_t> executed_per_worker;
+};
+
+// Task scheduler shared by several submitters (e.g. every interface of a multi-task run), so cheap
+// and expensive work draw from one set of cores instead of fixed per-task threads.
+//
+// Every worker owns one deque per priority level. A worker pops its own newest task first (LIFO,
+// cache-warm), and when its deques are empty it steals the oldest task of another worker (FIFO).
+// Higher priorities are exhausted across all deques before lower ones are looked at. Tasks posted
+// from outside the pool are spread round-robin; tasks posted from a worker go to its own deque.
+// Deadline tasks go to one shared earliest-deadline-first queue that every worker checks first.
+class WorkStealingPool
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+private:
+    struct TimedTask {
+        Task fn;
+        Clock::time_point deadline;
+        bool operator>(const TimedTask &other) const { return deadline > other.deadline; }
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> deques[static_cast<size_t>(TaskPriority::Count)];
+        size_t executed = 0;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex deadline_mutex;
+    std::priority_queue<TimedTask, std::vector<TimedTask>, std::greater<TimedTask>> deadline_queue;
+
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> next_worker{0};
+    std::atomic<size_t> stolen{0};
+    std::atomic<size_t> deadline_tasks{0};
+    std::atomic<size_t> deadline_misses{0};
+    std::mutex sleep_mutex;
+    std::condition_variable cond_work;
+    bool stopped = false;
+
+    // Set on each worker thread; lets post() and wait() tell this pool's workers from other threads.
+    static inline thread_local const WorkStealingPool *current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+
+    // Index of the current thread in this pool, or -1 for outside threads.
+    int worker_index() const
+    {
+        return this == current_pool ? static_cast<int>(current_index) : -1;
+    }
+
+    bool pop_deadline(Task &task)
+    {
+        std::lock_guard<std::mutex> lock(deadline_mutex);
+        if (deadline_queue.empty()) return false;
+        if (Clock::now() > deadline_queue.top().deadline) deadline_misses++;
+        task = std::move(const_cast<TimedTask &>(deadline_queue.top()).fn);
+        deadline_queue.pop();
+        return true;
+    }
+
+    // Own deque from the back, then the other workers' deques from the front, one priority at a time.
+    bool pop_task(size_t self, Task &task)
+    {
+        if (pop_deadline(task)) return true;
+        for (size_t level = 0; level < static_cast<size_t>(TaskPriority::Count); ++level) {
+            {
+                Worker &own = *workers[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.deques[level].empty()) {
+                    task = std::move(own.deques[level].back());
+                    own.deques[level].pop_back();
+                    return true;
+                }
+            }
+            for (size_t k = 1; k < workers.size(); ++k) {
+                Worker &victim = *workers[(self + k) % workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.deques[level].empty()) {
+                    task = std::move(victim.deques[level].front());
+                    victim.deques[level].pop_front();
+                    stolen++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool run_one(size_t self)
+    {
+        Task task;
+        if (!pop_task(self, task)) return false;
+        pending--;
+        task();
+        std::lock_guard<std::mutex> lock(workers[self]->mutex);
+        workers[self]->executed++;
+        return true;
+    }
+
+    void worker_loop(size_t self)
+    {
+        current_pool = this;
+        current_index = self;
+        while (true) {
+            if (run_one(self)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            cond_work.wait(lock, [this] { return stopped || pending > 0; });
+            if (stopped && 0 == pending) return;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t worker_count = std::thread::hardware_concurrency())
+    {
+        worker_count = std::max<size_t>(1, worker_count);
+        for (size_t i = 0; i < worker_count; ++i) workers.push_back(std::make_unique<Worker>());
+        for (size_t i = 0; i < worker_count; ++i) workers[i]->thread = std::thread(&WorkStealingPool::worker_loop, this, i);
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Runs every task already posted, then joins the workers.
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopped = true;
+        }
+        cond_work.notify_all();
+        for (auto &worker : workers) worker->thread.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Fire-and-forget. The task must not throw; use submit() to get errors back.
+    void post(Task task, TaskHints hints = TaskHints())
+    {
+        // Counted before it is queued, so a worker that takes it never sees the count go negative.
+        pending++;
+        if (hints.has_deadline()) {
+            std::lock_guard<std::mutex> lock(deadline_mutex);
+            deadline_queue.push(TimedTask{std::move(task), hints.deadline});
+            deadline_tasks++;
+        } else {
+            const int self = worker_index();
+            Worker &target = *workers[self >= 0 ? static_cast<size_t>(self) : next_worker++ % workers.size()];
+            std::lock_guard<std::mutex> lock(target.mutex);
+            target.deques[static_cast<size_t>(hints.priority)].push_back(std::move(task));
+        }
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        cond_work.notify_one();
+    }
+
+    template <typename Fn>
+    auto submit(Fn &&fn, TaskHints hints = TaskHints()) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        std::future<Result> future = task->get_future();
+        post([task] { (*task)(); }, hints);
+        return future;
+    }
+
+    // Waits for `future`. A pool worker that waits keeps running other tasks meanwhile, so nested
+    // waits cannot deadlock the pool; other threads simply block.
+    template <typename T>
+    T wait(std::future<T> &future)
+    {
+        const int self = worker_index();
+        if (self >= 0) {
+            while (std::future_status::ready != future.wait_for(std::chrono::seconds(0))) {
+                if (!run_one(static_cast<size_t>(self))) future.wait_for(std::chrono::microseconds(50));
+            }
+        }
+        return future.get();
+    }
+
+    WorkStealingStats get_stats()
+    {
+        WorkStealingStats stats;
+        for (auto &worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            stats.executed_per_worker.push_back(worker->executed);
+            stats.executed += worker->executed;
+        }
+        stats.stolen = stolen;
+        stats.deadline_tasks = deadline_tasks;
+        stats.deadline_misses = deadline_misses;
+        return stats;
+    }
+};
+
+// Runs a submitter's preprocessing and inference on a WorkStealingPool shared with other submitters,
+// e.g. for a multi-task run:
+//   auto pool = std::make_shared<WorkStealingPool>();
+//   make_shared<Pooled_Submitter_Implementation>(make_shared<ImageClassification_Interface_Implementation>(), pool, TaskHints{TaskPriority::High});
+//   make_shared<Pooled_Submitter_Implementation>(make_shared<Segmentation_Interface_Implementation>(), pool, TaskHints{TaskPriority::Low}, 1);
+//
+// A batch is split into tasks of `queries_per_task` queries that any idle worker can pick up, so
+// segmentation backlog spreads over the cores the cheaper tasks leave idle. With queries_per_task > 0
+// the inner submitter must allow concurrent inferVision/inferLLM calls (the ORT examples do; the
+// LLM example keeps per-call scratch buffers and needs 0). 0 runs each batch as one task.
+// `latency_budget` > 0 turns every task into a deadline task due that long after it was submitted.
+class Pooled_Submitter_Implementation : public AI_BMT_Interface
+{
+private:
+    std::shared_ptr<AI_BMT_Interface> inner;
+    std::shared_ptr<WorkStealingPool> pool;
+    TaskHints hints;
+    size_t queries_per_task;
+    std::chrono::microseconds latency_budget;
+
+    TaskHints task_hints() const
+    {
+        TaskHints task = hints;
+        if (latency_budget.count() > 0) task.deadline = WorkStealingPool::Clock::now() + latency_budget;
+        return task;
+    }
+
+    template <typename Result, typename InferFn>
+    std::vector<Result> run_batch(const std::vector<VariantType> &data, InferFn infer_fn)
+    {
+        if (0 == queries_per_task || data.size() <= queries_per_task) {
+            auto future = pool->submit([&] { return infer_fn(data); }, task_hints());
+            return pool->wait(future);
+        }
+        std::vector<std::future<std::vector<Result>>> futures;
+        for (size_t begin = 0; begin < data.size(); begin += queries_per_task) {
+            const size_t end = std::min(begin + queries_per_task, data.size());
+            futures.push_back(pool->submit([&, begin, end] {
+                return infer_fn(std::vector<VariantType>(data.begin() + begin, data.begin() + end));
+            }, task_hints()));
+        }
+        // Every future is waited for before rethrowing, since the tasks reference `data`.
+        std::vector<Result> results;
+        results.reserve(data.size());
+        std::exception_ptr error;
+        for (auto &future : futures) {
+            try {
+                for (auto &result : pool->wait(future)) results.push_back(std::move(result));
+            }
+            catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+        return results;
+    }
+
+public:
+    Pooled_Submitter_Implementation(std::shared_ptr<AI_BMT_Interface> inner, std::shared_ptr<WorkStealingPool> pool,
+                                    TaskHints hints = TaskHints(), size_t queries_per_task = 1,
+                                    std::chrono::microseconds latency_budget = std::chrono::microseconds(0))
+        : inner(std::move(inner)), pool(std::move(pool)), hints(hints), queries_per_task(queries_per_task),
+          latency_budget(latency_budget)
+    {
+        if (!this->pool) throw std::invalid_argument("Pooled_Submitter_Implementation needs a pool");
+    }
+
+    virtual InterfaceType getInterfaceType() override { return inner->getInterfaceType(); }
+    virtual Optional_Data getOptionalData() override { return inner->getOptionalData(); }
+    virtual void initialize(string modelPath) override { inner->initialize(modelPath); }
+
+    virtual VariantType preprocessVisionData(const string &imagePath) override
+    {
+        auto future = pool->submit([&] { return inner->preprocessVisionData(imagePath); }, task_hints());
+        return pool->wait(future);
+    }
+
+    virtual VariantType preprocessLLMData(const LLMPreprocessedInput &llmData) override
+    {
+        auto future = pool->submit([&] { return inner->preprocessLLMData(llmData); }, task_hints());
+        return pool->wait(future);
+    }
+
+    virtual vector<BMTVisionResult> inferVision(const vector<VariantType> &data) override
+    {
+        return run_batch<BMTVisionResult>(data, [this](const std::vector<VariantType> &batch) { return inner->inferVision(batch); });
+    }
+
+    virtual vector<BMTLLMResult> inferLLM(const vector<VariantType> &data) override
+    {
+        return run_batch<BMTLLMResult>(data, [this](const std::vector<VariantType> &batch) { return inner->inferLLM(batch); });
+    }
+};
+
+#endif /* _WORK_STEALING_POOL_HPP_ */